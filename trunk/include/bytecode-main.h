@@ -15,6 +15,15 @@
 #define DEBUG_CODEGEN FALSE
 #endif
 
+/* Compile with -DMLTON_BYTECODE_SWITCH to interpret with the switch
+ * rather than direct threading.
+ */
+#ifdef MLTON_BYTECODE_SWITCH
+#define MLtonBytecodeUseSwitch() MLton_Bytecode_useSwitch = TRUE
+#else
+#define MLtonBytecodeUseSwitch() MLton_Bytecode_useSwitch = FALSE
+#endif
+
 PRIVATE extern struct Bytecode MLton_bytecode;
 
 static GC_frameIndex returnAddressToFrameIndex (GC_returnAddress ra) {
@@ -22,23 +31,25 @@ static GC_frameIndex returnAddressToFrameIndex (GC_returnAddress ra) {
 }
 
 #define MLtonCallFromC                                                  \
+/* Globals */                                                           \
+C_Pthread_Key_t gcstate_key;                                            \
 static void MLton_callFromC () {                                        \
         uintptr_t nextFun;                                              \
         GC_state s;                                                     \
                                                                         \
         if (DEBUG_CODEGEN)                                              \
                 fprintf (stderr, "MLton_callFromC() starting\n");       \
-        s = &gcState;                                                   \
-        GC_setSavedThread (s, GC_getCurrentThread (s));                 \
+        s = &gcState[0];                                                \
+        GC_setSavedThread (&gcState, GC_getCurrentThread (&gcState));   \
         s->atomicState += 3;                                            \
         if (s->signalsInfo.signalIsPending)                             \
                 s->limit = s->limitPlusSlop - GC_HEAP_LIMIT_SLOP;       \
         /* Switch to the C Handler thread. */                           \
-        GC_switchToThread (s, GC_getCallFromCHandlerThread (s), 0);     \
+        GC_switchToThread (s, GC_getCallFromCHandlerThread (&gcState), 0); \
         nextFun = *(uintptr_t*)(s->stackTop - GC_RETURNADDRESS_SIZE);   \
         MLton_Bytecode_interpret (&MLton_bytecode, nextFun);            \
         s->atomicState += 1;                                            \
-        GC_switchToThread (s, GC_getSavedThread (s), 0);                \
+        GC_switchToThread (s, GC_getSavedThread (&gcState), 0);         \
         s->atomicState -= 1;                                            \
         if (0 == s->atomicState                                         \
             && s->signalsInfo.signalIsPending)                          \
@@ -47,41 +58,58 @@ static void MLton_callFromC () {                                        \
                 fprintf (stderr, "MLton_callFromC done\n");             \
 }                                                                       \
 
-#define MLtonMain(al, mg, mfs, mmc, pk, ps, ml)                         \
-MLtonCallFromC                                                          \
-PUBLIC int MLton_main (int argc, char* argv[]) {                        \
-        uintptr_t nextFun;                                              \
-        Initialize (al, mg, mfs, mmc, pk, ps);                          \
-        if (gcState.amOriginal) {                                       \
+/* The interpreter runs on a single processor, so there is only one
+ * GC state and no processor threads, timer thread or profiling
+ * thread.
+ */
+#define MLtonInitialize(al, mg, mfs, mmc, pk, ps, gnr, ml)              \
+        {                                                               \
+                struct GC_state s;                                      \
+                Initialize (s, al, mg, mfs, mmc, pk, ps, gnr);          \
+                if (1 != s.numberOfProcs)                               \
+                        die ("Bytecode programs run on one processor."); \
+                gcState = (GC_state) malloc (sizeof (struct GC_state)); \
+                if (pthread_key_create (&gcstate_key, NULL)) {          \
+                        fprintf (stderr, "pthread_key_create failed: %s\n", strerror (errno)); \
+                        exit (1);                                       \
+                }                                                       \
+                memcpy (&gcState[0], &s, sizeof (struct GC_state));     \
+                gcState[0].procStates = gcState;                        \
+                GC_lateInit (&gcState[0]);                              \
+        }                                                               \
+        pthread_setspecific (gcstate_key, &gcState[0]);                 \
+        gcState[0].pthread = pthread_self ();                           \
+        GC_startProfilingTime (&gcState[0]);                            \
+        MLtonBytecodeUseSwitch ();                                      \
+        if (gcState[0].amOriginal) {                                    \
                 real_Init();                                            \
                 nextFun = ml;                                           \
         } else {                                                        \
                 /* Return to the saved world */                         \
-                nextFun = *(uintptr_t*)(gcState.stackTop - GC_RETURNADDRESS_SIZE); \
-        }                                                               \
+                nextFun = *(uintptr_t*)(gcState[0].stackTop - GC_RETURNADDRESS_SIZE); \
+        }
+
+#define MLtonMain(al, mg, mfs, mmc, pk, ps, gnr, ml)                    \
+MLtonCallFromC                                                          \
+PUBLIC int MLton_main (int argc, char* argv[]) {                        \
+        uintptr_t nextFun;                                              \
+        MLtonInitialize (al, mg, mfs, mmc, pk, ps, gnr, ml);            \
         MLton_Bytecode_interpret (&MLton_bytecode, nextFun);            \
         return 1;                                                       \
 }
 
-#define MLtonLibrary(al, mg, mfs, mmc, pk, ps, ml)                      \
+#define MLtonLibrary(al, mg, mfs, mmc, pk, ps, gnr, ml)                 \
 MLtonCallFromC                                                          \
 PUBLIC void LIB_OPEN(LIBNAME) (int argc, char* argv[]) {                \
         uintptr_t nextFun;                                              \
-        Initialize (al, mg, mfs, mmc, pk, ps);                          \
-        if (gcState.amOriginal) {                                       \
-                real_Init();                                            \
-                nextFun = ml;                                           \
-        } else {                                                        \
-                /* Return to the saved world */                         \
-                nextFun = *(uintptr_t*)(gcState.stackTop - GC_RETURNADDRESS_SIZE); \
-        }                                                               \
+        MLtonInitialize (al, mg, mfs, mmc, pk, ps, gnr, ml);            \
         MLton_Bytecode_interpret (&MLton_bytecode, nextFun);            \
 }                                                                       \
 PUBLIC void LIB_CLOSE(LIBNAME) () {                                     \
         uintptr_t nextFun;                                              \
-        nextFun = *(uintptr_t*)(gcState.stackTop - GC_RETURNADDRESS_SIZE); \
+        nextFun = *(uintptr_t*)(gcState[0].stackTop - GC_RETURNADDRESS_SIZE); \
         MLton_Bytecode_interpret (&MLton_bytecode, nextFun);            \
-        GC_done(&gcState);                                              \
+        GC_done(&gcState[0]);                                           \
 }
 
 #endif /* #ifndef _BYTECODE_MAIN_H */
@@ -95,14 +95,12 @@
 #define Chunk(n)                                                \
         DeclareChunk(n) {                                       \
                 struct cont cont;                               \
-                Pointer GCState = (Pointer)(pthread_getspecific (gcstate_key)); \
                 register unsigned int frontier asm("g5");       \
                 register unsigned int stackTop asm("g6");
 #else
 #define Chunk(n)                                \
         DeclareChunk(n) {                       \
                 struct cont cont;               \
-                Pointer GCState = (Pointer)(pthread_getspecific (gcstate_key)); \
                 Pointer frontier;               \
                 Pointer stackTop;
 #endif
@@ -27,13 +27,18 @@ struct cont {
         uintptr_t nextFun;
 };
 
-PRIVATE extern struct cont (*nextChunks []) (void);
+PRIVATE extern struct cont (*nextChunks []) (uintptr_t, Pointer);
 PRIVATE extern struct GC_state * gcState;
 
 #define ChunkName(n) Chunk ## n
 
+/* The trampoline passes each chunk the processor's GC_state, so that
+ * a transfer between chunks doesn't have to look it up in
+ * gcstate_key.  A thread never changes processors, so the trampoline
+ * only looks it up once.
+ */
 #define DeclareChunk(n)                         \
-        struct cont ChunkName(n)(uintptr_t l_nextFun)
+        struct cont ChunkName(n)(uintptr_t l_nextFun, Pointer GCState)
 
 #define Chunkp(n) &(ChunkName(n))
 
@@ -43,4 +48,7 @@ PRIVATE extern struct GC_state * gcState;
                 cont.nextFun = l;                       \
         } while (0)
 
+#define CallChunk(cont, s)                                              \
+        (*(struct cont(*)(uintptr_t, Pointer))cont.nextChunk)(cont.nextFun, (Pointer)(s))
+
 #endif /* #ifndef _C_COMMON_H_ */
@@ -36,7 +36,7 @@ void MLton_callFromC (pointer ffiOpArgsResPtr) {                        \
         cont.nextChunk = nextChunks[cont.nextFun];                      \
         s->returnToC = FALSE;                                           \
         do {                                                            \
-                cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
+                cont=CallChunk(cont, s);                                \
         } while (not s->returnToC);                                     \
         s->returnToC = FALSE;                                           \
         printf ("\nMLtonCallFromC");                                    \
@@ -187,14 +187,16 @@ void run (void *arg) {                                                  \
         /* Save our state locally */                                    \
         pthread_setspecific (gcstate_key, s);                           \
         s->pthread = pthread_self ();                                   \
+        GC_startProfilingTime (s);                                      \
                                                                         \
         /* Mask ALRM and PROF signal */                                 \
         sigset_t blockSet;                                              \
         sigemptyset (&blockSet);                                        \
         if (s->enableTimer)                                             \
             sigaddset (&blockSet, SIGALRM);                             \
-        if (s->profiling.kind == PROFILE_TIME_FIELD ||                  \
-            s->profiling.kind == PROFILE_TIME_LABEL)                    \
+        if ((s->profiling.kind == PROFILE_TIME_FIELD ||                 \
+             s->profiling.kind == PROFILE_TIME_LABEL)                   \
+            && !s->profiling.hasThreadTimer)                            \
             sigaddset (&blockSet, SIGPROF);                             \
         pthread_sigmask (SIG_SETMASK, &blockSet, NULL);                 \
                                                                         \
@@ -210,14 +212,14 @@ void run (void *arg) {                                                  \
         if (Proc_amPrimary (s)) {                                       \
                 /* Trampoline */                                        \
                 while (1) {                                             \
-                        cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
-                        cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
-                        cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
-                        cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
-                        cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
-                        cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
-                        cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
-                        cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
+                        cont=CallChunk(cont, s);                        \
+                        cont=CallChunk(cont, s);                        \
+                        cont=CallChunk(cont, s);                        \
+                        cont=CallChunk(cont, s);                        \
+                        cont=CallChunk(cont, s);                        \
+                        cont=CallChunk(cont, s);                        \
+                        cont=CallChunk(cont, s);                        \
+                        cont=CallChunk(cont, s);                        \
                 }                                                       \
         }                                                               \
         else {                                                          \
@@ -268,8 +270,10 @@ PUBLIC int MLton_main (int argc, char* argv[]) {                        \
                     exit (1);                                           \
             }                                                           \
         }                                                               \
-        if(gcState[0].profiling.kind == PROFILE_TIME_LABEL ||           \
-           gcState[0].profiling.kind == PROFILE_TIME_FIELD) {           \
+        /* Without per-thread timers, one thread passes on SIGPROF */   \
+        if((gcState[0].profiling.kind == PROFILE_TIME_LABEL ||          \
+            gcState[0].profiling.kind == PROFILE_TIME_FIELD)            \
+           && !gcState[0].profiling.hasThreadTimer) {                   \
              if(pthread_create (&profHandlerThread, NULL, &runProfHandler, (void*)&gcState[0])) { \
                     fprintf (stderr, "pthread_create failed: %s\n", strerror (errno)); \
                     exit (1);                                           \
@@ -298,7 +302,7 @@ PUBLIC void LIB_OPEN(LIBNAME) (int argc, char* argv[]) {                \
         /* Trampoline */                                                \
         s->returnToC = FALSE;                                           \
         do {                                                            \
-                cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
+                cont=CallChunk(cont, s);                                \
         } while (not s->returnToC);                                     \
 }                                                                       \
 PUBLIC void LIB_CLOSE(LIBNAME) () {                                     \
@@ -308,7 +312,7 @@ PUBLIC void LIB_CLOSE(LIBNAME) () {                                     \
         cont.nextChunk = nextChunks[cont.nextFun];                      \
         s->returnToC = FALSE;                                           \
         do {                                                            \
-                cont=(*(struct cont(*)(uintptr_t))cont.nextChunk)(cont.nextFun); \
+                cont=CallChunk(cont, s);                                \
         } while (not s->returnToC);                                     \
         GC_done(s);                                                     \
 }
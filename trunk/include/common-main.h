@@ -110,6 +110,8 @@ void Duplicate (GC_state d, GC_state s) {
   d->profiling.kind = s->profiling.kind;
   d->profiling.stack = s->profiling.stack;
   d->profiling.isProfilingTimeOn = false;
+  /* Tells run whether to leave SIGPROF to runProfHandler. */
+  d->profiling.hasThreadTimer = s->profiling.hasThreadTimer;
   d->globalObjptrNonRoot = s->globalObjptrNonRoot;
   GC_duplicate (d, s);
 }
@@ -53,6 +53,12 @@ PRIVATE extern const C_Int_t MLton_Itimer_VIRTUAL;
 PRIVATE C_Errno_t(C_PId_t) MLton_Process_cwait(C_PId_t,Ref(C_Status_t));
 PRIVATE C_Errno_t(C_PId_t) MLton_Process_spawne(NullString8_t,Array(NullString8_t),Array(NullString8_t));
 PRIVATE C_Errno_t(C_PId_t) MLton_Process_spawnp(NullString8_t,Array(NullString8_t));
+PRIVATE C_Errno_t(C_Int_t) MLton_Reactor_arm(C_Int_t,C_Fd_t,C_Int_t,C_Int_t);
+PRIVATE C_Errno_t(C_Int_t) MLton_Reactor_disarm(C_Int_t,C_Fd_t);
+PRIVATE extern const C_Int_t MLton_Reactor_HANGUP;
+PRIVATE extern const C_Int_t MLton_Reactor_READ;
+PRIVATE C_Errno_t(C_Int_t) MLton_Reactor_wait(C_Int_t,Array(C_Int_t),Array(C_Int_t),C_Int_t);
+PRIVATE extern const C_Int_t MLton_Reactor_WRITE;
 PRIVATE extern const C_Int_t MLton_Rlimit_AS;
 PRIVATE extern const C_Int_t MLton_Rlimit_CORE;
 PRIVATE extern const C_Int_t MLton_Rlimit_CPU;
@@ -383,6 +389,7 @@ PRIVATE C_Errno_t(C_Off_t) Posix_IO_lseek(C_Fd_t,C_Off_t,C_Int_t);
 PRIVATE extern const C_Int_t Posix_IO_O_ACCMODE;
 PRIVATE C_Errno_t(C_Int_t) Posix_IO_pipe(Array(C_Fd_t));
 PRIVATE C_Errno_t(C_SSize_t) Posix_IO_readChar8(C_Fd_t,Array(Char8_t),C_Int_t,C_Size_t);
+PRIVATE C_Errno_t(C_SSize_t) Posix_IO_readv(C_Fd_t,Vector(C_Pointer_t),Vector(C_Size_t),C_Int_t);
 PRIVATE C_Errno_t(C_SSize_t) Posix_IO_readWord8(C_Fd_t,Array(Word8_t),C_Int_t,C_Size_t);
 PRIVATE extern const C_Int_t Posix_IO_SEEK_CUR;
 PRIVATE extern const C_Int_t Posix_IO_SEEK_END;
@@ -391,6 +398,7 @@ PRIVATE void Posix_IO_setbin(C_Fd_t);
 PRIVATE void Posix_IO_settext(C_Fd_t);
 PRIVATE C_Errno_t(C_SSize_t) Posix_IO_writeChar8Arr(C_Fd_t,Array(Char8_t),C_Int_t,C_Size_t);
 PRIVATE C_Errno_t(C_SSize_t) Posix_IO_writeChar8Vec(C_Fd_t,Vector(Char8_t),C_Int_t,C_Size_t);
+PRIVATE C_Errno_t(C_SSize_t) Posix_IO_writev(C_Fd_t,Vector(C_Pointer_t),Vector(C_Size_t),C_Int_t);
 PRIVATE C_Errno_t(C_SSize_t) Posix_IO_writeWord8Arr(C_Fd_t,Array(Word8_t),C_Int_t,C_Size_t);
 PRIVATE C_Errno_t(C_SSize_t) Posix_IO_writeWord8Vec(C_Fd_t,Vector(Word8_t),C_Int_t,C_Size_t);
 PRIVATE C_String_t Posix_ProcEnv_ctermid(void);
@@ -915,6 +923,7 @@ PRIVATE C_Errno_t(C_SSize_t) Socket_recvFrom(C_Sock_t,Array(Word8_t),C_Int_t,C_S
 PRIVATE C_Errno_t(C_Int_t) Socket_select(Vector(C_Fd_t),Vector(C_Fd_t),Vector(C_Fd_t),Array(C_Int_t),Array(C_Int_t),Array(C_Int_t));
 PRIVATE C_Errno_t(C_SSize_t) Socket_sendArr(C_Sock_t,Array(Word8_t),C_Int_t,C_Size_t,C_Int_t);
 PRIVATE C_Errno_t(C_SSize_t) Socket_sendArrTo(C_Sock_t,Array(Word8_t),C_Int_t,C_Size_t,C_Int_t,Vector(Word8_t),C_Socklen_t);
+PRIVATE C_Errno_t(C_SSize_t) Socket_sendMsg(C_Sock_t,Vector(C_Pointer_t),Vector(C_Size_t),C_Int_t,C_Int_t);
 PRIVATE C_Errno_t(C_SSize_t) Socket_sendVec(C_Sock_t,Vector(Word8_t),C_Int_t,C_Size_t,C_Int_t);
 PRIVATE C_Errno_t(C_SSize_t) Socket_sendVecTo(C_Sock_t,Vector(Word8_t),C_Int_t,C_Size_t,C_Int_t,Vector(Word8_t),C_Socklen_t);
 PRIVATE void Socket_setTimeout(C_Time_t,C_SUSeconds_t);
@@ -934,6 +943,7 @@ PRIVATE void Socket_UnixSock_toAddr(NullString8_t,C_Size_t,Array(Word8_t),Ref(C_
 PRIVATE void Stdio_print(String8_t);
 PRIVATE void Stdio_printStderr(String8_t);
 PRIVATE void Stdio_printStdout(String8_t);
+PRIVATE Word64_t Time_getMonotonic(void);
 PRIVATE C_Int_t Time_getTimeOfDay(Ref(C_Time_t),Ref(C_SUSeconds_t));
 PRIVATE C_Errno_t(C_PId_t) Windows_Process_create(NullString8_t,NullString8_t,NullString8_t,C_Fd_t,C_Fd_t,C_Fd_t);
 PRIVATE C_Errno_t(C_Int_t) Windows_Process_terminate(C_PId_t,C_Signal_t);
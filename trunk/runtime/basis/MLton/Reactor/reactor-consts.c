@@ -0,0 +1,5 @@
+#include "platform.h"
+
+const C_Int_t MLton_Reactor_HANGUP = GC_REACTOR_HANGUP;
+const C_Int_t MLton_Reactor_READ = GC_REACTOR_READ;
+const C_Int_t MLton_Reactor_WRITE = GC_REACTOR_WRITE;
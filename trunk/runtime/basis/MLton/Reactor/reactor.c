@@ -0,0 +1,34 @@
+#include "platform.h"
+
+C_Errno_t(C_Int_t) MLton_Reactor_arm (C_Int_t proc, C_Fd_t fd,
+                                      C_Int_t events, C_Int_t token) {
+  struct GC_reactor *r;
+
+  r = Parallel_reactor (proc);
+  if (NULL == r) {
+    errno = ENOSYS;
+    return -1;
+  }
+  return GC_reactorArm (r, fd, (uint32_t)events, (uint32_t)token);
+}
+
+C_Errno_t(C_Int_t) MLton_Reactor_disarm (C_Int_t proc, C_Fd_t fd) {
+  struct GC_reactor *r;
+
+  r = Parallel_reactor (proc);
+  if (NULL == r) {
+    errno = ENOSYS;
+    return -1;
+  }
+  return GC_reactorDisarm (r, fd);
+}
+
+C_Errno_t(C_Int_t) MLton_Reactor_wait (C_Int_t timeout,
+                                       Array(C_Int_t) tokens,
+                                       Array(C_Int_t) events,
+                                       C_Int_t max) {
+  return Parallel_reactorWait (timeout,
+                               (uint32_t *)tokens,
+                               (uint32_t *)events,
+                               max);
+}
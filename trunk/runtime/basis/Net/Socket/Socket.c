@@ -88,6 +88,26 @@ Socket_sendVecTo (C_Sock_t s, Vector(Word8_t) msg,
   return Socket_sendTo (s, (Pointer)msg, start, len, flags, addr, addrlen);
 }
 
+/* Like Posix_IO_writev, from pinned buffers. */
+C_Errno_t(C_SSize_t)
+Socket_sendMsg (C_Sock_t s, Vector(C_Pointer_t) bs, Vector(C_Size_t) ls,
+                C_Int_t n, C_Int_t flags) {
+  struct iovec iov[MLTON_IOV_MAX];
+  struct msghdr msg;
+
+  MLton_initSockets ();
+  if (n > MLTON_IOV_MAX)
+    n = MLTON_IOV_MAX;
+  for (int i = 0; i < n; i++) {
+    iov[i].iov_base = (void *)((C_Pointer_t *)bs)[i];
+    iov[i].iov_len = ((C_Size_t *)ls)[i];
+  }
+  memset (&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = n;
+  return sendmsg (s, &msg, flags);
+}
+
 C_Errno_t(C_Int_t) Socket_shutdown (C_Sock_t s, C_Int_t how) {
   MLton_initSockets ();
   return shutdown (s, how);
@@ -0,0 +1,19 @@
+#include "platform.h"
+
+/* The buffers are pinned, so the bases are addresses that stay put.
+ * Any past the first MLTON_IOV_MAX are left for the caller to pass
+ * again, as after any other short read.
+ */
+C_Errno_t(C_SSize_t)
+Posix_IO_readv (C_Fd_t fd, Vector(C_Pointer_t) bs, Vector(C_Size_t) ls,
+                C_Int_t n) {
+  struct iovec iov[MLTON_IOV_MAX];
+
+  if (n > MLTON_IOV_MAX)
+    n = MLTON_IOV_MAX;
+  for (int i = 0; i < n; i++) {
+    iov[i].iov_base = (void *)((C_Pointer_t *)bs)[i];
+    iov[i].iov_len = ((C_Size_t *)ls)[i];
+  }
+  return readv (fd, iov, n);
+}
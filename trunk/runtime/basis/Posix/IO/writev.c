@@ -0,0 +1,16 @@
+#include "platform.h"
+
+/* See readv.c. */
+C_Errno_t(C_SSize_t)
+Posix_IO_writev (C_Fd_t fd, Vector(C_Pointer_t) bs, Vector(C_Size_t) ls,
+                 C_Int_t n) {
+  struct iovec iov[MLTON_IOV_MAX];
+
+  if (n > MLTON_IOV_MAX)
+    n = MLTON_IOV_MAX;
+  for (int i = 0; i < n; i++) {
+    iov[i].iov_base = (void *)((C_Pointer_t *)bs)[i];
+    iov[i].iov_len = ((C_Size_t *)ls)[i];
+  }
+  return writev (fd, iov, n);
+}
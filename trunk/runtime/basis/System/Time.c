@@ -11,6 +11,28 @@ C_Int_t Time_getTimeOfDay (Ref(C_Time_t) sec, Ref(C_SUSeconds_t) usec) {
   return res;
 }
 
+/* Nanoseconds on a clock that never goes backwards, from an arbitrary
+ * start.  The coarse clock, where there is one, is only as fine as the
+ * kernel's tick, but is much cheaper to read.  Without a monotonic
+ * clock, this falls back to the time of day, which can go backwards
+ * when the system clock is set.
+ */
+Word64_t Time_getMonotonic (void) {
+  struct timeval tv;
+#if (defined (CLOCK_MONOTONIC))
+  struct timespec ts;
+
+#if (defined (CLOCK_MONOTONIC_COARSE))
+  if (0 == clock_gettime (CLOCK_MONOTONIC_COARSE, &ts))
+    return (Word64_t)ts.tv_sec * 1000000000 + (Word64_t)ts.tv_nsec;
+#endif
+  if (0 == clock_gettime (CLOCK_MONOTONIC, &ts))
+    return (Word64_t)ts.tv_sec * 1000000000 + (Word64_t)ts.tv_nsec;
+#endif
+  gettimeofday (&tv, (struct timezone*)NULL);
+  return (Word64_t)tv.tv_sec * 1000000000 + (Word64_t)tv.tv_usec * 1000;
+}
+
 C_Clock_t Time_clock () {
     return clock ();
 }
@@ -42,6 +42,28 @@ enum {
   DEBUG_BYTECODE = FALSE,
 };
 
+/* Direct threading.
+ *
+ * With GCC, rather than going back around the main loop, each handler
+ * jumps straight to the handler for the next opcode, through a table
+ * of label addresses indexed by opcode.  Handlers that fall through
+ * to the next instruction read its opcode as soon as they have fetched
+ * their operands.  The switch is still used to disassemble and debug,
+ * and for programs compiled with -DMLTON_BYTECODE_SWITCH, so that the
+ * two can be compared.
+ */
+#if (defined (__GNUC__) && ! defined (MLTON_BYTECODE_NO_THREADING))
+#define BYTECODE_THREADED TRUE
+#define opcodeLabel(sym)  opcodeLabelSym (sym)
+#define opcodeLabelSym(sym)  label_##sym
+#define Case(sym)  case sym: opcodeLabel (sym)
+#else
+#define BYTECODE_THREADED FALSE
+#define Case(sym)  case sym
+#endif
+
+PRIVATE Bool MLton_Bytecode_useSwitch = FALSE;
+
 #if defined (GC_MODEL_NATIVE32)
 #define WordPointer Word32
 #define WordArrayIndex Word32
@@ -63,9 +85,6 @@ typedef Word16 RegIndex;
 typedef Word8 Scale;
 typedef Int16 StackOffset;  // StackOffset must be signed.
 
-/* XXX KC : make sure this works */
-PRIVATE struct GC_state gcState;
-
 //----------------------------------------------------------------------
 // Imports
 //----------------------------------------------------------------------
@@ -85,8 +104,6 @@ regs(Word16);
 regs(Word32);
 regs(Word64);
 
-PRIVATE extern Objptr globalObjptrNonRoot[];
-
 #undef regs
 
 //
@@ -109,6 +126,42 @@ PRIVATE extern Objptr globalObjptrNonRoot[];
                 pc += sizeof (t);                                       \
         } while (0)
 
+/* Fetched () follows the fetch of a handler's operands, and Next ()
+ * ends a handler that falls through to the next instruction.  Jump ()
+ * dispatches on the instruction at pc, for branches.
+ */
+#if BYTECODE_THREADED
+#define Fetched()                                       \
+        do {                                            \
+                if (disassemble) goto mainLoop;         \
+                if (threaded) nextOpc = *(Opcode*)pc;   \
+        } while (0)
+#define Next()                                          \
+        do {                                            \
+                if (threaded) {                         \
+                        pc += sizeof (Opcode);          \
+                        goto *dispatchTable[nextOpc];   \
+                }                                       \
+                goto mainLoop;                          \
+        } while (0)
+#define Jump()                                          \
+        do {                                            \
+                if (threaded) {                         \
+                        nextOpc = *(Opcode*)pc;         \
+                        pc += sizeof (Opcode);          \
+                        goto *dispatchTable[nextOpc];   \
+                }                                       \
+                goto mainLoop;                          \
+        } while (0)
+#else
+#define Fetched()                                       \
+        do {                                            \
+                if (disassemble) goto mainLoop;         \
+        } while (0)
+#define Next()  goto mainLoop
+#define Jump()  goto mainLoop
+#endif
+
 enum {
         MODE_load,
         MODE_store,
@@ -133,7 +186,7 @@ enum {
 #define loadStore(mode, t, z)  loadStoreGen(mode, t, t, z)
 
 #define loadStoreArrayOffset(mode, ty)                                          \
-        case opcodeSymOfTy2 (ty, mode##ArrayOffset):                            \
+        Case (opcodeSymOfTy2 (ty, mode##ArrayOffset)):                          \
         {                                                                       \
                 ArrayOffset arrayOffset;                                        \
                 Pointer arrayBase;                                              \
@@ -141,132 +194,185 @@ enum {
                 Scale arrayScale;                                               \
                 Fetch (ArrayOffset, arrayOffset);                               \
                 Fetch (Scale, arrayScale);                                      \
-                if (disassemble) goto mainLoop;                                 \
+                Fetched ();                                                     \
                 arrayIndex = PopRegX (WordArrayIndex);                          \
                 arrayBase = (Pointer) (PopRegX (WordPointer));                  \
                 loadStore (mode, ty,                                            \
                                 *(ty*)(arrayBase + (arrayIndex * arrayScale) + arrayOffset)); \
-                goto mainLoop;                                                  \
+                Next ();                                                        \
         }
 
 #define loadStoreContents(mode, ty)                             \
-        case opcodeSymOfTy2 (ty, mode##Contents):               \
-                if (disassemble) goto mainLoop;                 \
+        Case (opcodeSymOfTy2 (ty, mode##Contents)):             \
+                Fetched ();                                     \
         {                                                       \
                 Pointer base;                                   \
                 base = (Pointer) (PopRegX (WordPointer));       \
                 loadStore (mode, ty, C (ty, base));             \
-                goto mainLoop;                                  \
+                Next ();                                        \
         }
 
 #define loadStoreFrontier(mode)                                 \
-        case opcodeSym (mode##Frontier):                        \
-                if (disassemble) goto mainLoop;                 \
+        Case (opcodeSym (mode##Frontier)):                      \
+                Fetched ();                                     \
                 loadStoreGen (mode, Pointer, WordPointer, Frontier); \
-                goto mainLoop;
+                Next ();
 
 #define loadGCState()                                   \
-        case opcodeSym (loadGCState):                   \
-                if (disassemble) goto mainLoop;         \
-                StoreReg (WordPointer, (WordPointer)&gcState); \
-                goto mainLoop;
+        Case (opcodeSym (loadGCState)):                 \
+                Fetched ();                             \
+                StoreReg (WordPointer, (WordPointer)gcState); \
+                Next ();
 
 #define loadStoreGlobal(mode, ty)                                       \
-        case opcodeSymOfTy2 (ty, mode##Global):                         \
+        Case (opcodeSymOfTy2 (ty, mode##Global)):                       \
         {                                                               \
                 GlobalIndex globalIndex;                                \
                 Fetch (GlobalIndex, globalIndex);                       \
-                if (disassemble) goto mainLoop;                         \
+                Fetched ();                                             \
                 loadStoreGen (mode, ty, ty, G (ty, globalIndex));       \
-                goto mainLoop;                                          \
+                Next ();                                                \
         }
 
 #define loadStoreGlobalPointer(mode, ty)                                        \
-        case opcodeSymOfTy2 (ty, mode##Global):                                 \
+        Case (opcodeSymOfTy2 (ty, mode##Global)):                               \
         {                                                                       \
                 GlobalIndex globalIndex;                                        \
                 Fetch (GlobalIndex, globalIndex);                               \
-                if (disassemble) goto mainLoop;                                 \
+                Fetched ();                                                     \
                 loadStoreGen (mode, ty, WordPointer, G (ty, globalIndex));      \
-                goto mainLoop;                                                  \
+                Next ();                                                        \
         }
 
 #define loadStoreGPNR(mode)                                                     \
-        case opcodeSym (mode##GPNR):                                            \
+        Case (opcodeSym (mode##GPNR)):                                          \
         {                                                                       \
                 GlobalIndex globalIndex;                                        \
                 Fetch (GlobalIndex, globalIndex);                               \
-                if (disassemble) goto mainLoop;                                 \
+                Fetched ();                                                     \
                 loadStoreGen (mode, Objptr, WordPointer, GPNR (globalIndex));   \
-                goto mainLoop;                                                  \
+                Next ();                                                        \
         }
 
 #define loadStoreOffset(mode, ty)                                       \
-        case opcodeSymOfTy2 (ty, mode##Offset):                         \
+        Case (opcodeSymOfTy2 (ty, mode##Offset)):                       \
         {                                                               \
                 Pointer base;                                           \
                 Offset offset;                                          \
                 Fetch (Offset, offset);                                 \
-                if (disassemble) goto mainLoop;                         \
+                Fetched ();                                             \
                 base = (Pointer) (PopRegX (WordPointer));               \
                 maybe loadStore (mode, ty, O (ty, base, offset));       \
-                goto mainLoop;                                          \
+                Next ();                                                \
         }
 
 #define loadStoreRegister(mode, ty)                             \
-        case opcodeSymOfTy2 (ty, mode##Register):               \
+        Case (opcodeSymOfTy2 (ty, mode##Register)):             \
         {                                                       \
                 RegIndex regIndex;                              \
                 Fetch (RegIndex, regIndex);                     \
-                if (disassemble) goto mainLoop;                 \
+                Fetched ();                                     \
                 loadStoreGen (mode, ty, ty, R (ty, regIndex));  \
-                goto mainLoop;                                  \
+                Next ();                                        \
         }
 
 #define loadStoreRegisterPointer(mode, ty)                                      \
-        case opcodeSymOfTy2 (ty, mode##Register):                               \
+        Case (opcodeSymOfTy2 (ty, mode##Register)):                             \
         {                                                                       \
                 RegIndex regIndex;                                              \
                 Fetch (RegIndex, regIndex);                                     \
-                if (disassemble) goto mainLoop;                                 \
+                Fetched ();                                                     \
                 loadStoreGen (mode, ty, WordPointer, R (ty, regIndex));         \
-                goto mainLoop;                                                  \
+                Next ();                                                        \
         }
 
 #define loadStoreStackOffset(mode, ty)                          \
-        case opcodeSymOfTy2 (ty, mode##StackOffset):            \
+        Case (opcodeSymOfTy2 (ty, mode##StackOffset)):          \
         {                                                       \
                 StackOffset stackOffset;                        \
                 Fetch (StackOffset, stackOffset);               \
-                if (disassemble) goto mainLoop;                 \
+                Fetched ();                                     \
                 loadStore (mode, ty, S (ty, stackOffset));      \
-                goto mainLoop;                                  \
+                Next ();                                        \
+        }
+
+#define loadStoreRegisterOffset(mode, ty)                               \
+        Case (opcodeSymOfTy2 (ty, mode##RegisterOffset)):               \
+        {                                                               \
+                RegIndex regIndex;                                      \
+                Offset offset;                                          \
+                Fetch (RegIndex, regIndex);                             \
+                Fetch (Offset, offset);                                 \
+                Fetched ();                                             \
+                loadStore (mode, ty,                                    \
+                                O (ty, (Pointer) R (Objptr, regIndex), offset)); \
+                Next ();                                                \
+        }
+
+#define moveRegister(ty)                                        \
+        Case (opcodeSymOfTy2 (ty, moveRegister)):               \
+        {                                                       \
+                RegIndex src, dst;                              \
+                Fetch (RegIndex, src);                          \
+                Fetch (RegIndex, dst);                          \
+                Fetched ();                                     \
+                R (ty, dst) = R (ty, src);                      \
+                Next ();                                        \
+        }
+
+#define moveRegisterToStackOffset(ty)                                   \
+        Case (opcodeSymOfTy2 (ty, moveRegisterToStackOffset)):          \
+        {                                                               \
+                RegIndex regIndex;                                      \
+                StackOffset stackOffset;                                \
+                Fetch (RegIndex, regIndex);                             \
+                Fetch (StackOffset, stackOffset);                       \
+                Fetched ();                                             \
+                S (ty, stackOffset) = R (ty, regIndex);                 \
+                Next ();                                                \
         }
 
+#define moveStackOffsetToRegister(ty)                                   \
+        Case (opcodeSymOfTy2 (ty, moveStackOffsetToRegister)):          \
+        {                                                               \
+                StackOffset stackOffset;                                \
+                RegIndex regIndex;                                      \
+                Fetch (StackOffset, stackOffset);                       \
+                Fetch (RegIndex, regIndex);                             \
+                Fetched ();                                             \
+                R (ty, regIndex) = S (ty, stackOffset);                 \
+                Next ();                                                \
+        }
+
+#define movesOfTy(ty)                           \
+        moveRegister (ty)                       \
+        moveRegisterToStackOffset (ty)          \
+        moveStackOffsetToRegister (ty)
+
 #define loadStoreStackTop(mode)                                 \
-        case opcodeSym (mode##StackTop):                        \
-                if (disassemble) goto mainLoop;                 \
+        Case (opcodeSym (mode##StackTop)):                      \
+                Fetched ();                                     \
                 loadStoreGen (mode, Pointer, WordPointer, StackTop); \
-                goto mainLoop;
+                Next ();
 
 #define loadWord(size)                                  \
-        case opcodeSymOfTy (Word, size, loadWord):      \
+        Case (opcodeSymOfTy (Word, size, loadWord)):    \
         {                                               \
                 Word##size t0;                          \
                 Fetch (Word##size, t0);                 \
-                if (disassemble) goto mainLoop;         \
+                Fetched ();                             \
                 loadStore (load, Word##size, t0);       \
-                goto mainLoop;                          \
+                Next ();                                \
         }
 
 #define binary(ty, f)                           \
-        case opcodeSym (f):                     \
-                if (disassemble) goto mainLoop; \
+        Case (opcodeSym (f)):                   \
+                Fetched ();                     \
         {                                       \
                 ty t0 = PopReg (ty);            \
                 ty t1 = PopReg (ty);            \
                 PushReg (ty) = f (t0, t1);      \
-                goto mainLoop;                  \
+                Next ();                        \
         }
 
 /* The bytecode interpreter relies on the fact that the overflow checking
@@ -275,117 +381,117 @@ enum {
  * the stack for the result.
  */
 #define binaryCheck(ty, f)                                      \
-        case opcodeSym (f):                                     \
-                if (disassemble) goto mainLoop;                 \
+        Case (opcodeSym (f)):                                   \
+                Fetched ();                                     \
         {                                                       \
                 ty t0 = PopReg (ty);                            \
                 ty t1 = PopReg (ty);                            \
                 f (PushReg (ty), t0, t1, f##Overflow);          \
                 overflow = FALSE;                               \
-                goto mainLoop;                                  \
+                Next ();                                        \
         f##Overflow:                                            \
                 PushReg (ty) = 0; /* overflow, push 0 */        \
                 overflow = TRUE;                                \
-                goto mainLoop;                                  \
+                Next ();                                        \
         }
 
 #define coerceOp(n, f, t)  opcodeSym (f##_##n##To##t)
 #define coerce(n, f1, t1, f2, t2)                       \
-        case coerceOp (n, f2, t2):                      \
-                if (disassemble) goto mainLoop;         \
+        Case (coerceOp (n, f2, t2)):                    \
+                Fetched ();                             \
         {                                               \
                 f1 t0 = PopReg (f1);                    \
                 PushReg (t1) = f2##_##n##To##t2 (t0);   \
-                goto mainLoop;                          \
+                Next ();                                \
         }
 
 #define compare(ty, f)                          \
-        case opcodeSym (f):                     \
-                if (disassemble) goto mainLoop; \
+        Case (opcodeSym (f)):                   \
+                Fetched ();                     \
         {                                       \
                 ty t0 = PopReg (ty);            \
                 ty t1 = PopReg (ty);            \
                 PushReg (Word32) = f (t0, t1);  \
-                goto mainLoop;                  \
+                Next ();                        \
         }
 
 #define cpointerBinary(f)                               \
-        case opcodeSym (f):                             \
-                if (disassemble) goto mainLoop;         \
+        Case (opcodeSym (f)):                           \
+                Fetched ();                             \
         {                                               \
                 Pointer t0;                             \
                 t0 = (Pointer) (PopRegX (WordPointer)); \
                 WordPointer t1 = PopRegX (WordPointer); \
                 Pointer t2 = f (t0, t1);                \
                 PushRegX (WordPointer) = (WordPointer) t2; \
-                goto mainLoop;                          \
+                Next ();                                \
         }
 #define cpointerCompare(f)                              \
-        case opcodeSym (f):                             \
-                if (disassemble) goto mainLoop;         \
+        Case (opcodeSym (f)):                           \
+                Fetched ();                             \
         {                                               \
                 Pointer t0, t1;                         \
                 t0 = (Pointer) (PopRegX (WordPointer)); \
                 t1 = (Pointer) (PopRegX (WordPointer)); \
                 PushReg (Word32) = f (t0, t1);          \
-                goto mainLoop;                          \
+                Next ();                                \
         }
 #define cpointerCoerceFrom(f)                           \
-        case opcodeSym (f):                             \
-                if (disassemble) goto mainLoop;         \
+        Case (opcodeSym (f)):                           \
+                Fetched ();                             \
         {                                               \
                 WordPointer t0 = PopRegX (WordPointer); \
                 Pointer t1 = f (t0);                    \
                 PushRegX (WordPointer) = (WordPointer) t1; \
-                goto mainLoop;                          \
+                Next ();                                \
         }
 #define cpointerCoerceTo(f)                             \
-        case opcodeSym (f):                             \
-                if (disassemble) goto mainLoop;         \
+        Case (opcodeSym (f)):                           \
+                Fetched ();                             \
         {                                               \
                 Pointer t0;                             \
                 t0 = (Pointer) (PopRegX (WordPointer)); \
                 PushRegX (WordPointer) = f (t0);        \
-                goto mainLoop;                          \
+                Next ();                                \
         }
 #define cpointerDiff(f)                                 \
-        case opcodeSym (f):                             \
-                if (disassemble) goto mainLoop;         \
+        Case (opcodeSym (f)):                           \
+                Fetched ();                             \
         {                                               \
                 Pointer t0, t1;                         \
                 t0 = (Pointer) (PopRegX (WordPointer)); \
                 t1 = (Pointer) (PopRegX (WordPointer)); \
                 PushRegX (WordPointer) = f (t0, t1);    \
-                goto mainLoop;                          \
+                Next ();                                \
         }
 #define cpointerLoadWord(f)                             \
-        case opcodeSym (f):                             \
+        Case (opcodeSym (f)):                           \
         {                                               \
                 size_t t0;                              \
                 Fetch (WordPointer, t0);                \
-                if (disassemble) goto mainLoop;         \
+                Fetched ();                             \
                 StoreReg (CPointer, (CPointer)t0);      \
-                goto mainLoop;                          \
+                Next ();                                \
         }
 
 #define shift(ty, f)                            \
-        case opcodeSym (f):                     \
-                if (disassemble) goto mainLoop; \
+        Case (opcodeSym (f)):                   \
+                Fetched ();                     \
         {                                       \
                 ty w = PopReg (ty);             \
                 Word32 s = PopReg (Word32);     \
                 ty w2 = f (w, s);               \
                 PushReg (ty) = w2;              \
-                goto mainLoop;                  \
+                Next ();                        \
         }
 
 #define unary(ty, f)                            \
-        case opcodeSym (f):                     \
-                if (disassemble) goto mainLoop; \
+        Case (opcodeSym (f)):                   \
+                Fetched ();                     \
         {                                       \
                 ty t0 = PopReg (ty);            \
                 PushReg (ty) = f (t0);          \
-                goto mainLoop;                  \
+                Next ();                        \
         }
 
 /* The bytecode interpreter relies on the fact that the overflow checking
@@ -394,27 +500,27 @@ enum {
  * the stack for the result.
  */
 #define unaryCheck(ty, f)                                       \
-        case opcodeSym (f):                                     \
-                if (disassemble) goto mainLoop;                 \
+        Case (opcodeSym (f)):                                   \
+                Fetched ();                                     \
         {                                                       \
                 ty t0 = PopReg (ty);                            \
                 f (PushReg (ty), t0, f##Overflow);              \
                 overflow = FALSE;                               \
-                goto mainLoop;                                  \
+                Next ();                                        \
         f##Overflow:                                            \
                 PushReg (ty) = 0; /* overflow, push 0 */        \
                 overflow = TRUE;                                \
-                goto mainLoop;                                  \
+                Next ();                                        \
         }
 
 #define Goto(l)                                 \
         do {                                    \
                 maybe pc = code + l;            \
-                goto mainLoop;                  \
+                Jump ();                        \
         } while (0)
 
 #define Switch(size)                                                    \
-        case OPCODE_Switch##size:                                       \
+        Case (OPCODE_Switch##size):                                     \
         {                                                               \
                 Label label;                                            \
                 ProgramCounter lastCase;                                \
@@ -440,7 +546,7 @@ enum {
                         if (not disassemble and test == caseWord)       \
                                 Goto (label);                           \
                 }                                                       \
-                goto mainLoop;                                          \
+                Jump ();                                                \
         }
 
 typedef char *String;
@@ -449,22 +555,25 @@ typedef char *String;
 #undef CacheStackTop
 #undef FlushFrontier
 #undef FlushStackTop
+#undef GPNR
 #define CacheFrontier()                         \
         do {                                    \
-                frontier = gcState.frontier;    \
+                frontier = gcState->frontier;   \
         } while (0)
 #define CacheStackTop()                         \
         do {                                    \
-                stackTop = gcState.stackTop;    \
+                stackTop = gcState->stackTop;   \
         } while (0)
 #define FlushFrontier()                         \
         do {                                    \
-                gcState.frontier = frontier;    \
+                gcState->frontier = frontier;   \
         } while (0)
 #define FlushStackTop()                         \
         do {                                    \
-                gcState.stackTop = stackTop;    \
+                gcState->stackTop = stackTop;   \
         } while (0)
+/* The interpreter has no GCState argument to find the globals by. */
+#define GPNR(i) (gcState->globalObjptrNonRoot[i])
 
 #define disp(ty,ty2,fmt)                                        \
         for (i = 0; i < ty##RegI; ++i)                          \
@@ -496,7 +605,18 @@ static void interpret (Bytecode b, CodeOffset codeOffset, Bool disassemble) {
         ProgramCounter pc;
         ProgramCounter pcMax;
         Pointer stackTop;
-
+#if BYTECODE_THREADED
+#define opcodeAddress(z)  &&opcodeLabel (opcodeSym (z))
+        static const void *const dispatchTable [] = {
+#include "opcode-labels.h"
+        };
+#undef opcodeAddress
+        Opcode nextOpc = 0;
+        Bool threaded;
+
+        threaded = not (DEBUG or DEBUG_BYTECODE or disassemble
+                        or MLton_Bytecode_useSwitch);
+#endif
         code = b->code;
         pcMax = b->code + b->codeSize;
         if (DEBUG or DEBUG_BYTECODE or disassemble) {
@@ -531,51 +651,50 @@ mainLoop:
                 fprintf (stderr, "%s", opcodeStrings[opc]);
         switch ((enum OpcodeEnum)opc) {
         prims ();
-        case opcodeSym (CacheFrontier):
+        Case (opcodeSym (CacheFrontier)):
         {
-                if (disassemble) goto mainLoop;
+                Fetched ();
                 CacheFrontier ();
-                goto mainLoop;
+                Next ();
         }
-        case opcodeSym (FlushFrontier):
+        Case (opcodeSym (FlushFrontier)):
         {
-                if (disassemble) goto mainLoop;
+                Fetched ();
                 FlushFrontier ();
-                goto mainLoop;
+                Next ();
         }
-        case opcodeSym (CacheStackTop):
+        Case (opcodeSym (CacheStackTop)):
         {
-                if (disassemble) goto mainLoop;
+                Fetched ();
                 CacheStackTop ();
-                goto mainLoop;
+                Next ();
         }
-        case opcodeSym (FlushStackTop):
+        Case (opcodeSym (FlushStackTop)):
         {
-                if (disassemble) goto mainLoop;
+                Fetched ();
                 FlushStackTop ();
-                goto mainLoop;
+                Next ();
         }
-        case opcodeSym (BranchIfZero):
+        Case (opcodeSym (BranchIfZero)):
         {
                 Label label;
 
                 Fetch (Label, label);
-                if (disassemble) goto mainLoop;
+                Fetched ();
                 if (0 == PopReg (Word32))
                         Goto (label);
-                goto mainLoop;
+                Next ();
         }
-        case opcodeSym (CallC):
+        Case (opcodeSym (CallC)):
                 Fetch (CallCIndex, callCIndex);
-                unless (disassemble) {
-                        FlushFrontier ();
-                        FlushStackTop ();
-                        MLton_callC (callCIndex);
-                        CacheFrontier ();
-                        CacheStackTop ();
-                }
-                goto mainLoop;
-        case opcodeSym (Goto):
+                Fetched ();
+                FlushFrontier ();
+                FlushStackTop ();
+                MLton_callC (callCIndex);
+                CacheFrontier ();
+                CacheStackTop ();
+                Next ();
+        Case (opcodeSym (Goto)):
         {
                 Label label;
                 Fetch (Label, label);
@@ -583,24 +702,24 @@ mainLoop:
         }
         loadStoreGPNR(load);
         loadStoreGPNR(store);
-        case opcodeSym (JumpOnOverflow):
+        Case (opcodeSym (JumpOnOverflow)):
         {
                 Label label;
                 Fetch (Label, label);
                 if (overflow)
                         Goto (label);
-                goto mainLoop;
+                Jump ();
         }
-        case opcodeSym (Raise):
-                maybe StackTop = gcState.stackBottom + gcState.exnStack;
+        Case (opcodeSym (Raise)):
+                maybe StackTop = gcState->stackBottom + gcState->exnStack;
                 // fall through to Return.
-        case opcodeSym (Return):
+        Case (opcodeSym (Return)):
                 Goto (*(Label*)(StackTop - sizeof (Label)));
         Switch(8);
         Switch(16);
         Switch(32);
         Switch(64);
-        case opcodeSym (Thread_returnToC):
+        Case (opcodeSym (Thread_returnToC)):
                 if (disassemble) goto mainLoop;
                 FlushFrontier ();
                 FlushStackTop ();
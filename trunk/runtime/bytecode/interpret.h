@@ -60,6 +60,8 @@ typedef struct Bytecode {
 #define PushRegX(ty) PushReg(ty)
 
 PRIVATE void MLton_callC (int i);  // provided by client
+/* Use the switch rather than direct threading. */
+PRIVATE extern Bool MLton_Bytecode_useSwitch;
 PRIVATE void MLton_Bytecode_interpret (Bytecode b, CodeOffset codeOffset);
 
 #endif
@@ -61,6 +61,25 @@
         loadStoreFrontier (mode)                        \
         loadStoreStackTop (mode)
 
+/* Superinstructions, each doing the work of a common sequence of two
+ * of the instructions above: a field of the object in an Objptr
+ * register, and moves between registers and stack slots.
+ */
+#define superPrimsOfTy(ty)                              \
+        loadStoreRegisterOffset (load, ty)              \
+        loadStoreRegisterOffset (store, ty)             \
+        movesOfTy (ty)
+
+#define superPrims()                                    \
+        superPrimsOfTy (Real32)                         \
+        superPrimsOfTy (Real64)                         \
+        superPrimsOfTy (Word8)                          \
+        superPrimsOfTy (Word16)                         \
+        superPrimsOfTy (Word32)                         \
+        superPrimsOfTy (Word64)                         \
+        movesOfTy (CPointer)                            \
+        movesOfTy (Objptr)
+
 #define realPrimsOfSize(size)                           \
         binary (Real##size, Real##size##_add)           \
         binary (Real##size, Real##size##_div)           \
@@ -131,6 +150,7 @@
         loadStorePrims (store)                          \
         realPrimsOfSize (32)                            \
         realPrimsOfSize (64)                            \
+        superPrims ()                                   \
         wordPrimsOfSize (8)                             \
         wordPrimsOfSize (16)                            \
         wordPrimsOfSize (32)                            \
@@ -181,10 +201,15 @@
 #define loadStoreGlobalPointer(mode, ty)  opcodeName2 (ty, mode##Global)
 #define loadStoreOffset(mode, ty)  opcodeName2 (ty, mode##Offset)
 #define loadStoreRegister(mode, ty)  opcodeName2 (ty, mode##Register)
+#define loadStoreRegisterOffset(mode, ty)  opcodeName2 (ty, mode##RegisterOffset)
 #define loadStoreRegisterPointer(mode, ty)  opcodeName2 (ty, mode##Register)
 #define loadStoreStackOffset(mode, ty)  opcodeName2 (ty, mode##StackOffset)
 #define loadStoreStackTop(mode)  opcodeGen (mode##StackTop)
 #define loadWord(size)  opcodeName (Word, size, loadWord)
+#define movesOfTy(ty)                                   \
+        opcodeName2 (ty, moveRegister)                  \
+        opcodeName2 (ty, moveRegisterToStackOffset)     \
+        opcodeName2 (ty, moveStackOffsetToRegister)
 #define shift(ty, f)  opcodeGen (f)
 #define unary(ty, f)  opcodeGen (f)
 #define unaryCheck(ty, f)  opcodeGen (f)
@@ -228,10 +253,12 @@ typedef Word16 Opcode;
 #undef loadStoreGlobalPointer
 #undef loadStoreOffset
 #undef loadStoreRegister
+#undef loadStoreRegisterOffset
 #undef loadStoreRegisterPointer
 #undef loadStoreStackOffset
 #undef loadStoreStackTop
 #undef loadWord
+#undef movesOfTy
 #undef shift
 #undef unary
 #undef unaryCheck
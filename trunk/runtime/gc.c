@@ -24,11 +24,14 @@ extern C_Pthread_Key_t gcstate_key;
 #include "gc/call-stack.c"
 #include "gc/cheney-copy.c"
 #include "gc/controls.c"
+#include "gc/compress.c"
+#include "gc/concurrent-mark.c"
 #include "gc/copy-thread.c"
 #include "gc/current.c"
 #include "gc/dfs-mark.c"
 #include "gc/done.c"
 #include "gc/enter_leave.c"
+#include "gc/event-log.c"
 #include "gc/foreach.c"
 #include "gc/forward.c"
 #include "gc/frame.c"
@@ -38,6 +41,7 @@ extern C_Pthread_Key_t gcstate_key;
 #include "gc/generational.c"
 #include "gc/handler.c"
 #include "gc/hash-cons.c"
+#include "gc/heap-profile.c"
 #include "gc/heap.c"
 #include "gc/heap_predicates.c"
 #include "gc/init-world.c"
@@ -51,7 +55,10 @@ extern C_Pthread_Key_t gcstate_key;
 #include "gc/object.c"
 #include "gc/objptr.c"
 #include "gc/pack.c"
+#include "gc/parallel-copy.c"
+#include "gc/parallel-share.c"
 #include "gc/parallel.c"
+#include "gc/pinned.c"
 #include "gc/pointer.c"
 #include "gc/profiling.c"
 #include "gc/rusage.c"
@@ -60,6 +67,7 @@ extern C_Pthread_Key_t gcstate_key;
 #include "gc/size.c"
 #include "gc/sources.c"
 #include "gc/stack.c"
+#include "gc/statistics.c"
 #include "gc/switch-thread.c"
 #include "gc/thread.c"
 #include "gc/threadlet.c"
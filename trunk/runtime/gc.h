@@ -47,11 +47,16 @@ typedef GC_state GCState_t;
 #include "gc/controls.h"
 #include "gc/major.h"
 #include "gc/statistics.h"
+#include "gc/event-log.h"
 #include "gc/forward.h"
 #include "gc/cheney-copy.h"
+#include "gc/parallel-copy.h"
+#include "gc/parallel-share.h"
 #include "gc/hash-cons.h"
 #include "gc/dfs-mark.h"
 #include "gc/mark-compact.h"
+#include "gc/concurrent-mark.h"
+#include "gc/compress.h"
 #include "gc/invariant.h"
 #include "gc/atomic.h"
 #include "gc/enter_leave.h"
@@ -65,6 +70,8 @@ typedef GC_state GCState_t;
 #include "gc/sources.h"
 #include "gc/call-stack.h"
 #include "gc/profiling.h"
+#include "gc/heap-profile.h"
+#include "gc/pinned.h"
 #include "gc/rusage.h"
 #include "gc/gc_state.h"
 #include "gc/init-world.h"
@@ -20,7 +20,12 @@ void updateWeaksForCheneyCopy (GC_state s) {
     if (DEBUG_WEAK)
       fprintf (stderr, "updateWeaksForCheneyCopy  w = "FMTPTR"  ", (uintptr_t)w);
     p = objptrToPointer (w->objptr, s->heap->start);
-    if (GC_FORWARDED == getHeader (p)) {
+    /* Only a major GC frees pinned buffers, and only unmarked ones. */
+    if (isPointerPinned (p)
+        and (s->forwardState.amInMinorGC or isPointerMarked (p))) {
+      if (DEBUG_WEAK)
+        fprintf (stderr, "pinned\n");
+    } else if (GC_FORWARDED == getHeader (p)) {
       if (DEBUG_WEAK)
         fprintf (stderr, "forwarded from "FMTOBJPTR" to "FMTOBJPTR"\n",
                  w->objptr,
@@ -50,12 +55,14 @@ void swapHeapsForCheneyCopy (GC_state s) {
 void majorCheneyCopyGC (GC_state s) {
   size_t bytesCopied;
   struct rusage ru_start;
+  uint64_t phaseStart;
   pointer toStart;
 
   assert (s->secondaryHeap->size >= s->heap->oldGenSize);
   if (detailedGCTime (s))
     startTiming (&ru_start);
   s->cumulativeStatistics->numCopyingGCs++;
+  setGCEventKind (s, GC_EVENT_COPYING);
   s->forwardState.amInMinorGC = FALSE;
   if (DEBUG or s->controls->messages) {
     fprintf (stderr,
@@ -79,10 +86,25 @@ void majorCheneyCopyGC (GC_state s) {
    */
   assert (s->secondaryHeap->size >= s->heap->oldGenSize);
   toStart = alignFrontier (s, s->secondaryHeap->start);
-  s->forwardState.back = toStart;
-  foreachGlobalObjptr (s, forwardObjptr);
-  foreachObjptrInRange (s, toStart, &s->forwardState.back, forwardObjptr, TRUE);
+  phaseStart = getGCEventTime ();
+  if (shouldParallelCheneyCopy (s, toStart, s->forwardState.toLimit,
+                                s->heap->oldGenSize)) {
+    /* To-space is empty, so let each page land on the node of the
+     * worker that first copies into it.
+     */
+    if (s->controls->numa)
+      GC_numaFirstTouch (toStart, (size_t)(s->forwardState.toLimit - toStart));
+    s->forwardState.back =
+      parallelCheneyCopy (s, toStart, s->forwardState.toLimit, FALSE);
+  } else {
+    s->forwardState.back = toStart;
+    foreachGlobalObjptr (s, forwardObjptr);
+    phaseStart = addGCEventPhaseTime (s, GC_PHASE_ROOTS, phaseStart);
+    foreachObjptrInRange (s, toStart, &s->forwardState.back, forwardObjptr, TRUE);
+  }
   updateWeaksForCheneyCopy (s);
+  updateHeapProfileForCheneyCopy (s);
+  addGCEventPhaseTime (s, GC_PHASE_COPY, phaseStart);
   s->secondaryHeap->oldGenSize = s->forwardState.back - s->secondaryHeap->start;
   bytesCopied = s->secondaryHeap->oldGenSize;
   s->cumulativeStatistics->bytesCopied += bytesCopied;
@@ -105,6 +127,7 @@ void minorCheneyCopyGC (GC_state s) {
   size_t bytesFilled = 0;
   size_t bytesCopied;
   struct rusage ru_start;
+  uint64_t phaseStart;
 
   if (DEBUG_GENERATIONAL)
     fprintf (stderr, "minorGC  nursery = "FMTPTR"  frontier = "FMTPTR"\n",
@@ -149,16 +172,31 @@ void minorCheneyCopyGC (GC_state s) {
     assert (isFrontierAligned (s, s->forwardState.toStart));
     s->forwardState.toLimit = s->forwardState.toStart + bytesAllocated;
     assert (invariantForGC (s));
-    s->forwardState.back = s->forwardState.toStart;
-    /* Forward all globals.  Would like to avoid doing this once all
-     * the globals have been assigned.
+    phaseStart = getGCEventTime ();
+    /* In parallel, the workers may waste a little to-space, so they
+     * are allowed to use everything up to the nursery.
      */
-    foreachGlobalObjptr (s, forwardObjptrIfInNursery);
-    forwardInterGenerationalObjptrs (s);
-    foreachObjptrInRange (s, s->forwardState.toStart, &s->forwardState.back,
-                          forwardObjptrIfInNursery, TRUE);
+    if (shouldParallelCheneyCopy (s, s->forwardState.toStart,
+                                  s->heap->nursery, bytesAllocated)) {
+      s->forwardState.back =
+        parallelCheneyCopy (s, s->forwardState.toStart,
+                            s->heap->nursery, TRUE);
+    } else {
+      s->forwardState.back = s->forwardState.toStart;
+      /* Forward all globals.  Would like to avoid doing this once all
+       * the globals have been assigned.
+       */
+      foreachGlobalObjptr (s, forwardObjptrIfInNursery);
+      forwardInterGenerationalObjptrs (s, forwardObjptrIfInNursery);
+      phaseStart = addGCEventPhaseTime (s, GC_PHASE_ROOTS, phaseStart);
+      foreachObjptrInRange (s, s->forwardState.toStart, &s->forwardState.back,
+                            forwardObjptrIfInNursery, TRUE);
+    }
     updateWeaksForCheneyCopy (s);
+    updateHeapProfileForCheneyCopy (s);
+    addGCEventPhaseTime (s, GC_PHASE_COPY, phaseStart);
     bytesCopied = s->forwardState.back - s->forwardState.toStart;
+    s->eventLog->current.bytesPromoted = bytesCopied;
     s->cumulativeStatistics->bytesCopiedMinor += bytesCopied;
     s->heap->oldGenSize += bytesCopied;
     s->lastMajorStatistics->numMinorGCs++;
@@ -0,0 +1,211 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+static inline uint32_t lzRead32 (const uint8_t *p) {
+  uint32_t x;
+
+  memcpy (&x, p, sizeof (uint32_t));
+  return x;
+}
+
+static inline uint32_t lzHash (uint32_t x) {
+  return (x * 2654435761U) >> (32 - LZ_HASH_LOG);
+}
+
+/* Writes the bytes that extend a length of 15 or more. */
+static inline uint8_t *lzWriteLength (uint8_t *op, size_t len) {
+  for (; len >= 255; len -= 255)
+    *op++ = 255;
+  *op++ = (uint8_t)len;
+  return op;
+}
+
+/* Bytes needed for a sequence, assuming the worst for the lengths. */
+static inline size_t lzSequenceBound (size_t literals, size_t matchLen) {
+  return 1 + literals / 255 + 1 + literals + 2 + matchLen / 255 + 1;
+}
+
+/* lzCompress (src, srcLen, dst, dstCapacity)
+ *
+ * returns the size of the compressed data, or 0 if it doesn't fit in
+ * dstCapacity.
+ */
+size_t lzCompress (const uint8_t *src, size_t srcLen,
+                   uint8_t *dst, size_t dstCapacity) {
+  /* Positions + 1 of the last four bytes seen with each hash. */
+  uint32_t table[1 << LZ_HASH_LOG];
+  const uint8_t *ip, *anchor, *iend;
+  uint8_t *op, *oend;
+  uint8_t *token;
+  size_t literals;
+
+  assert (srcLen <= UINT32_MAX);
+  memset (table, 0, sizeof (table));
+  ip = src;
+  anchor = src;
+  iend = src + srcLen;
+  op = dst;
+  oend = dst + dstCapacity;
+  if (srcLen >= LZ_MF_LIMIT) {
+    const uint8_t *mfLimit = iend - LZ_MF_LIMIT;
+    const uint8_t *matchLimit = iend - LZ_LAST_LITERALS;
+
+    while (ip < mfLimit) {
+      const uint8_t *ref, *mp, *rp;
+      uint32_t seq, h, candidate;
+      size_t matchLen;
+
+      seq = lzRead32 (ip);
+      h = lzHash (seq);
+      candidate = table[h];
+      table[h] = (uint32_t)(ip - src) + 1;
+      ref = (0 == candidate) ? NULL : src + candidate - 1;
+      if (NULL == ref
+          or ip - ref > LZ_MAX_OFFSET
+          or lzRead32 (ref) != seq) {
+        /* Skip faster through data that doesn't compress. */
+        ip += 1 + ((size_t)(ip - anchor) >> 6);
+        continue;
+      }
+      mp = ip + LZ_MIN_MATCH;
+      rp = ref + LZ_MIN_MATCH;
+      while (mp < matchLimit and *mp == *rp) {
+        mp++;
+        rp++;
+      }
+      literals = ip - anchor;
+      matchLen = mp - ip - LZ_MIN_MATCH;
+      if (lzSequenceBound (literals, matchLen) > (size_t)(oend - op))
+        return 0;
+      token = op++;
+      *token = (uint8_t)((min (literals, (size_t)15) << 4)
+                         | min (matchLen, (size_t)15));
+      if (literals >= 15)
+        op = lzWriteLength (op, literals - 15);
+      memcpy (op, anchor, literals);
+      op += literals;
+      *op++ = (uint8_t)((ip - ref) & 0xFF);
+      *op++ = (uint8_t)((ip - ref) >> 8);
+      if (matchLen >= 15)
+        op = lzWriteLength (op, matchLen - 15);
+      ip = mp;
+      anchor = ip;
+    }
+  }
+  literals = iend - anchor;
+  if (lzSequenceBound (literals, 0) > (size_t)(oend - op))
+    return 0;
+  token = op++;
+  *token = (uint8_t)(min (literals, (size_t)15) << 4);
+  if (literals >= 15)
+    op = lzWriteLength (op, literals - 15);
+  memcpy (op, anchor, literals);
+  op += literals;
+  return op - dst;
+}
+
+/* Reads the bytes that extend a length of 15, returning FALSE if they
+ * run past end.
+ */
+static inline bool lzReadLength (const uint8_t **ipp, const uint8_t *end,
+                                 size_t *len) {
+  uint8_t b;
+
+  do {
+    if (*ipp >= end)
+      return FALSE;
+    b = *(*ipp)++;
+    *len += b;
+  } while (255 == b);
+  return TRUE;
+}
+
+/* lzDecompress (src, srcLen, dst, dstLen)
+ *
+ * returns TRUE iff src decompresses to exactly dstLen bytes.  It never
+ * reads or writes out of bounds, whatever src holds.
+ */
+bool lzDecompress (const uint8_t *src, size_t srcLen,
+                   uint8_t *dst, size_t dstLen) {
+  const uint8_t *ip, *iend;
+  uint8_t *op, *oend;
+
+  ip = src;
+  iend = src + srcLen;
+  op = dst;
+  oend = dst + dstLen;
+  while (ip < iend) {
+    const uint8_t *ref;
+    uint8_t token;
+    size_t len, offset;
+
+    token = *ip++;
+    len = token >> 4;
+    if (15 == len and not lzReadLength (&ip, iend, &len))
+      return FALSE;
+    if (len > (size_t)(iend - ip) or len > (size_t)(oend - op))
+      return FALSE;
+    memcpy (op, ip, len);
+    op += len;
+    ip += len;
+    if (ip == iend)
+      break;
+    if (iend - ip < 2)
+      return FALSE;
+    offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+    if (0 == offset or offset > (size_t)(op - dst))
+      return FALSE;
+    len = token & 15;
+    if (15 == len and not lzReadLength (&ip, iend, &len))
+      return FALSE;
+    len += LZ_MIN_MATCH;
+    if (len > (size_t)(oend - op))
+      return FALSE;
+    /* The match may overlap what it produces; copy it in pieces that
+     * don't, each twice as long as the last.
+     */
+    ref = op - offset;
+    while (len > 0) {
+      size_t n = min (len, (size_t)(op - ref));
+
+      memcpy (op, ref, n);
+      op += n;
+      len -= n;
+    }
+  }
+  return op == oend;
+}
+
+#define ADLER_MOD 65521
+/* The most bytes that can be summed before the sums must be reduced. */
+#define ADLER_NMAX 5552
+
+/* Continues the Adler-32 checksum adler over len more bytes. */
+uint32_t updateAdler32 (uint32_t adler, const uint8_t *buf, size_t len) {
+  uint32_t a, b;
+
+  a = adler & 0xFFFF;
+  b = adler >> 16;
+  while (len > 0) {
+    size_t n = min (len, (size_t)ADLER_NMAX);
+
+    len -= n;
+    for (; n > 0; n--) {
+      a += *buf++;
+      b += a;
+    }
+    a %= ADLER_MOD;
+    b %= ADLER_MOD;
+  }
+  return (b << 16) | a;
+}
+
+uint32_t computeAdler32 (const uint8_t *buf, size_t len) {
+  return updateAdler32 (1, buf, len);
+}
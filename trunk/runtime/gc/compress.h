@@ -0,0 +1,39 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* A byte-oriented LZ77 codec in the LZ4 block format: a sequence is a
+ * token (literal length in the high nibble, match length - 4 in the
+ * low), any extra length bytes, the literals, a little-endian 16-bit
+ * offset, and any extra match length bytes.  The last sequence has
+ * only literals.  It is fast rather than tight, which suits heaps,
+ * with their runs of zeros and repeated headers.
+ */
+
+#define LZ_HASH_LOG 12
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+/* The last match starts at least LZ_MF_LIMIT bytes before the end,
+ * and the last LZ_LAST_LITERALS bytes are always literals.
+ */
+#define LZ_MF_LIMIT 12
+#define LZ_LAST_LITERALS 5
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static size_t lzCompress (const uint8_t *src, size_t srcLen,
+                          uint8_t *dst, size_t dstCapacity);
+static bool lzDecompress (const uint8_t *src, size_t srcLen,
+                          uint8_t *dst, size_t dstLen);
+static uint32_t updateAdler32 (uint32_t adler, const uint8_t *buf, size_t len);
+static uint32_t computeAdler32 (const uint8_t *buf, size_t len);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -0,0 +1,296 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* ---------------------------------------------------------------- */
+/*                      Concurrent Marking                          */
+/* ---------------------------------------------------------------- */
+
+/* Unlike dfsMarkByMode, the marker can't reverse pointers in objects
+ * that the mutators are using, so it keeps an explicit mark stack.
+ * Only the marker (or, during the remark, the collector) sets mark
+ * bits, and only in [heapStart, limit), which is the old generation
+ * as it was when marking started.  Stacks are changed by the mutators
+ * without marking cards, so the marker only marks them and leaves
+ * them to the remark.
+ */
+static struct {
+  volatile GC_concurrentMarkState state;
+  volatile bool stop;
+  GC_state collector;
+  pthread_t thread;
+  pointer heapStart;
+  pointer boundary; /* end of the old generation when marking started */
+  pointer limit; /* objects at or past limit are not marked */
+  bool deferStacks;
+  pointer *markStack;
+  size_t markStackSize;
+  size_t markStackUsed;
+  pointer *stacks; /* stacks marked but not yet scanned */
+  size_t stacksSize;
+  size_t stacksUsed;
+  GC_weak weaks;
+  /* Cards dirtied since marking started, saved before the card map is
+   * cleared.  Covers [heapStart, boundary).
+   */
+  GC_cardMapElem *modUnion;
+  GC_cardMapIndex modUnionLength;
+} concurrentMark;
+
+bool isConcurrentMarkRunning (void) {
+  return GC_CONCURRENT_MARK_RUNNING == concurrentMark.state;
+}
+
+static void pushConcurrentMark (pointer **stack, size_t *size, size_t *used,
+                                pointer p) {
+  if (*used == *size) {
+    *size *= 2;
+    *stack = (pointer *) realloc_safe (*stack, *size * sizeof (pointer));
+  }
+  (*stack)[(*used)++] = p;
+}
+
+static void markObjptrConcurrently (__attribute__ ((unused)) GC_state s,
+                                    objptr *opp) {
+  objptr op;
+  pointer p;
+  GC_header *headerp;
+
+  op = *opp;
+  unless (isObjptr (op))
+    return;
+  p = objptrToPointer (op, concurrentMark.heapStart);
+  if (isPointerPinned (p)) {
+    markPinnedObjptr (s, op);
+    return;
+  }
+  unless (concurrentMark.heapStart <= p and p < concurrentMark.limit)
+    return;
+  headerp = getHeaderp (p);
+  if (MARK_MASK & *headerp)
+    return;
+  *headerp |= MARK_MASK;
+  if (DEBUG_CONCURRENT_MARK)
+    fprintf (stderr, "concurrently marked "FMTPTR"\n", (uintptr_t)p);
+  pushConcurrentMark (&concurrentMark.markStack,
+                      &concurrentMark.markStackSize,
+                      &concurrentMark.markStackUsed, p);
+}
+
+static void ignoreObjptr (__attribute__ ((unused)) GC_state s,
+                          __attribute__ ((unused)) objptr *opp) {
+}
+
+static void scanObjectConcurrently (GC_state s, pointer p) {
+  GC_objectTypeTag tag;
+
+  splitHeader (s, getHeader (p), &tag, NULL, NULL, NULL);
+  if (STACK_TAG == tag and concurrentMark.deferStacks) {
+    pushConcurrentMark (&concurrentMark.stacks,
+                        &concurrentMark.stacksSize,
+                        &concurrentMark.stacksUsed, p);
+    return;
+  }
+  if (WEAK_TAG == tag) {
+    GC_weak w;
+
+    w = (GC_weak)(p + offsetofWeak (s));
+    if (isObjptr (w->objptr)) {
+      w->link = concurrentMark.weaks;
+      concurrentMark.weaks = w;
+    }
+  }
+  foreachObjptrInObject (s, p, markObjptrConcurrently, TRUE);
+}
+
+/* Returns FALSE if it was asked to stop before running out of work. */
+static bool drainConcurrentMark (GC_state s) {
+  while (concurrentMark.markStackUsed > 0) {
+    if (concurrentMark.stop)
+      return FALSE;
+    scanObjectConcurrently
+      (s, concurrentMark.markStack[--concurrentMark.markStackUsed]);
+  }
+  return TRUE;
+}
+
+static void *runConcurrentMarker (__attribute__ ((unused)) void *arg) {
+  sigset_t set;
+
+  /* Leave signals to the processors. */
+  sigfillset (&set);
+  pthread_sigmask (SIG_BLOCK, &set, NULL);
+  if (drainConcurrentMark (concurrentMark.collector)
+      and (DEBUG_CONCURRENT_MARK
+           or concurrentMark.collector->controls->messages))
+    fprintf (stderr, "[GC: Finished concurrent mark.]\n");
+  return NULL;
+}
+
+/* Called at the end of performGC, with the world stopped and the
+ * nursery empty.
+ */
+void maybeStartConcurrentMark (GC_state s) {
+  GC_cardMapIndex length;
+
+  unless (s->controls->concurrentMark
+          and s->mutatorMarksCards
+          and not isConcurrentMarkRunning ()
+          and s->heap->oldGenSize >= s->heap->availableSize / 2)
+    return;
+  if (DEBUG_CONCURRENT_MARK or s->controls->messages)
+    fprintf (stderr,
+             "[GC: Starting concurrent mark of %s bytes.]\n",
+             uintmaxToCommaString (s->heap->oldGenSize));
+  if (NULL == concurrentMark.markStack) {
+    concurrentMark.markStackSize = GC_CONCURRENT_MARK_STACK_SIZE;
+    concurrentMark.markStack = (pointer *)
+      malloc_safe (concurrentMark.markStackSize * sizeof (pointer));
+    concurrentMark.stacksSize = GC_CONCURRENT_MARK_STACK_SIZE;
+    concurrentMark.stacks = (pointer *)
+      malloc_safe (concurrentMark.stacksSize * sizeof (pointer));
+  }
+  concurrentMark.collector = s;
+  concurrentMark.heapStart = s->heap->start;
+  concurrentMark.boundary = s->heap->start + s->heap->oldGenSize;
+  concurrentMark.limit = concurrentMark.boundary;
+  concurrentMark.deferStacks = TRUE;
+  concurrentMark.markStackUsed = 0;
+  concurrentMark.stacksUsed = 0;
+  concurrentMark.weaks = NULL;
+  length = sizeToCardMapIndex (align (s->heap->oldGenSize, CARD_SIZE));
+  if (length > concurrentMark.modUnionLength) {
+    free (concurrentMark.modUnion);
+    concurrentMark.modUnion = (GC_cardMapElem *)
+      malloc_safe (length * CARD_MAP_ELEM_SIZE);
+  }
+  concurrentMark.modUnionLength = length;
+  /* Earlier writes need not be recorded: the nursery is empty, so
+   * every pointer into objects promoted from now on will come from a
+   * later write.
+   */
+  memset (concurrentMark.modUnion, 0, length * CARD_MAP_ELEM_SIZE);
+  clearPinnedMarks ();
+  foreachGlobalObjptr (s, markObjptrConcurrently);
+  concurrentMark.stop = FALSE;
+  concurrentMark.state = GC_CONCURRENT_MARK_RUNNING;
+  s->cumulativeStatistics->numConcurrentMarks++;
+  if (pthread_create (&concurrentMark.thread, NULL, runConcurrentMarker, NULL))
+    diee ("Unable to start concurrent marker");
+}
+
+/* Called before the card map is cleared. */
+void saveCardMapForConcurrentMark (GC_state s) {
+  GC_cardMapElem *cardMap;
+
+  unless (isConcurrentMarkRunning ())
+    return;
+  cardMap = s->generationalMaps.cardMap;
+  for (GC_cardMapIndex i = 0; i < concurrentMark.modUnionLength; i++)
+    concurrentMark.modUnion[i] |= cardMap[i];
+}
+
+static void stopConcurrentMarker (void) {
+  concurrentMark.stop = TRUE;
+  if (pthread_join (concurrentMark.thread, NULL))
+    diee ("Unable to stop concurrent marker");
+  concurrentMark.state = GC_CONCURRENT_MARK_IDLE;
+}
+
+/* Rescan the marked objects on cards dirtied since marking started.
+ * Follows forwardInterGenerationalObjptrs, but only looks at the old
+ * generation as it was when marking started.
+ */
+static void remarkDirtyCards (GC_state s) {
+  GC_cardMapElem *cardMap;
+  GC_crossMapElem *crossMap;
+  GC_cardMapIndex cardIndex, maxCardIndex;
+  pointer cardStart, cardEnd;
+  pointer objectStart;
+  pointer p;
+
+  updateCrossMap (s);
+  cardMap = s->generationalMaps.cardMap;
+  crossMap = s->generationalMaps.crossMap;
+  maxCardIndex = concurrentMark.modUnionLength;
+  objectStart = alignFrontier (s, s->heap->start);
+  cardStart = s->heap->start;
+  for (cardIndex = 0; cardIndex < maxCardIndex; ) {
+    if (cardMap[cardIndex] or concurrentMark.modUnion[cardIndex]) {
+      cardEnd = min (cardStart + CARD_SIZE, concurrentMark.boundary);
+      while (objectStart < cardEnd) {
+        p = advanceToObjectData (s, objectStart);
+        objectStart =
+          foreachObjptrInObject (s, p,
+                                 isPointerMarked (p)
+                                 ? markObjptrConcurrently
+                                 : ignoreObjptr,
+                                 TRUE);
+      }
+      if (objectStart == concurrentMark.boundary)
+        break;
+      cardIndex = sizeToCardMapIndex (objectStart - s->heap->start);
+      cardStart = s->heap->start + cardMapIndexToSize (cardIndex);
+    } else {
+      unless (CROSS_MAP_EMPTY == crossMap[cardIndex])
+        objectStart = cardStart
+          + (size_t)(crossMap[cardIndex] * CROSS_MAP_OFFSET_SCALE);
+      cardIndex++;
+      cardStart += CARD_SIZE;
+    }
+  }
+}
+
+/* Called by majorMarkCompactGC instead of marking, after the minor GC,
+ * with the world stopped.  Finishes marking and links the live weaks
+ * into s->weaks.
+ */
+void finishConcurrentMark (GC_state s) {
+  pointer oldGenEnd;
+
+  assert (isConcurrentMarkRunning ());
+  assert (concurrentMark.heapStart == s->heap->start);
+  stopConcurrentMarker ();
+  if (DEBUG_CONCURRENT_MARK or s->controls->messages)
+    fprintf (stderr,
+             "[GC: Remarking; %s objects left to mark.]\n",
+             uintmaxToCommaString (concurrentMark.markStackUsed));
+  oldGenEnd = s->heap->start + s->heap->oldGenSize;
+  concurrentMark.limit = oldGenEnd;
+  concurrentMark.deferStacks = FALSE;
+  for (size_t i = 0; i < concurrentMark.stacksUsed; i++)
+    foreachObjptrInObject (s, concurrentMark.stacks[i],
+                           markObjptrConcurrently, TRUE);
+  concurrentMark.stacksUsed = 0;
+  foreachGlobalObjptr (s, markObjptrConcurrently);
+  remarkDirtyCards (s);
+  /* Everything promoted since marking started counts as a root. */
+  foreachObjptrInRange (s, concurrentMark.boundary, &oldGenEnd,
+                        markObjptrConcurrently, TRUE);
+  drainConcurrentMark (s);
+  s->weaks = concurrentMark.weaks;
+}
+
+/* Clear every mark the marker made; used before anything else that
+ * uses the mark bits or moves the heap.
+ */
+void abortConcurrentMark (GC_state s) {
+  pointer front;
+  pointer p;
+
+  unless (isConcurrentMarkRunning ())
+    return;
+  stopConcurrentMarker ();
+  if (DEBUG_CONCURRENT_MARK or s->controls->messages)
+    fprintf (stderr, "[GC: Abandoning concurrent mark.]\n");
+  front = alignFrontier (s, concurrentMark.heapStart);
+  while (front < concurrentMark.boundary) {
+    p = advanceToObjectData (s, front);
+    *getHeaderp (p) &= ~MARK_MASK;
+    front += sizeofObject (s, p);
+  }
+}
@@ -0,0 +1,41 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* Mostly-concurrent marking for the mark-compact collector.
+ *
+ * When the concurrent-mark control is set and the old generation is
+ * half full, a background thread starts marking the old generation as
+ * it was at the end of a GC, while the mutators keep running.  The
+ * mutators' writes are recorded by the card map, which is saved into
+ * a mod-union table whenever it is cleared.  The next mark-compact
+ * collection then only has to remark: retrace from the roots, from the
+ * marked objects on dirty cards, from stacks, and from everything
+ * promoted since marking started.
+ */
+
+/* Initial number of entries in the mark stack. */
+#define GC_CONCURRENT_MARK_STACK_SIZE 4096
+
+typedef enum {
+  GC_CONCURRENT_MARK_IDLE,
+  GC_CONCURRENT_MARK_RUNNING,
+} GC_concurrentMarkState;
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static inline bool isConcurrentMarkRunning (void);
+static void maybeStartConcurrentMark (GC_state s);
+static void saveCardMapForConcurrentMark (GC_state s);
+static void finishConcurrentMark (GC_state s);
+static void abortConcurrentMark (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -8,6 +8,8 @@
 
 #if (defined (MLTON_GC_INTERNAL_TYPES))
 
+#define GC_NUMA_PRIVATE_NURSERY_RATIO 0.5
+
 struct GC_ratios {
   /* Minimum live ratio to use copying GC. */
   float copy;
@@ -30,6 +32,14 @@ struct GC_ratios {
    * than nurseryRatio, use minor GCs.
    */
   float nursery;
+  /* Fraction of the free nursery that is divided evenly among the
+   * processors after each GC.  A processor allocates from its share
+   * without touching heap->frontier, and only competes for the shared
+   * remainder once its own is exhausted.  This is only an allocation
+   * share: there are no thread-local minor GCs.  Every minor GC still
+   * stops all of the processors and collects the whole nursery.
+   */
+  float privateNursery;
   float ramSlop;
   float stackCurrentGrow;
   float stackCurrentMaxReserved;
@@ -43,16 +53,29 @@ struct GC_ratios {
 };
 
 struct GC_controls {
+  const char *allocProfile; /* Write the allocation-sampling profile to this file. */
+  size_t allocSampleBytes; /* If zero, then no allocation sampling. */
   size_t fixedHeap; /* If 0, then no fixed heap-> */
+  char *gcTrace; /* Write the GC event log to this file, if not NULL. */
   size_t maxHeap; /* if zero, then unlimited, else limit total heap */
   bool mayLoadWorld;
   bool mayPageHeap; /* Permit paging heap to disk during GC */
+  bool compressWorld; /* Save worlds compressed, instead of mappable. */
   bool mayProcessAtMLton;
   bool messages; /* Print a message at the start and end of each gc. */
+  bool parallelGC; /* Use all processors for copying collections and hash consing. */
   size_t oldGenArraySize; /* Arrays larger are allocated in old gen, if possible. */
   size_t allocChunkSize; /* Minimum size reserved for any allocation request. */
   int32_t affinityBase; /* First processor to use when setting affinity */
   int32_t affinityStride; /* Number of processors between first and second */
+  /* Place each processor's nursery and copies on its node.  Private
+   * nurseries are bound to their processor's node, so numa raises a
+   * private-nursery ratio of 0 to GC_NUMA_PRIVATE_NURSERY_RATIO.  The
+   * shared remainder is left to first touch.
+   */
+  bool numa;
+  bool concurrentMark; /* Mark the old generation in the background. */
+  size_t pinnedSize; /* Address space reserved for pinned buffers. */
   bool restrictAvailableSize; /* Use smaller heaps to improve space profiling accuracy */
   struct GC_ratios ratios;
   bool rusageMeasureGC;
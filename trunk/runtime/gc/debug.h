@@ -15,6 +15,7 @@ enum {
   DEBUG_ARRAY = FALSE,
   DEBUG_CALL_STACK = FALSE,
   DEBUG_CARD_MARKING = FALSE,
+  DEBUG_CONCURRENT_MARK = FALSE,
   DEBUG_DETAILED = FALSE,
   DEBUG_DFS_MARK = FALSE,
   DEBUG_ENTER_LEAVE = FALSE,
@@ -24,6 +25,7 @@ enum {
   DEBUG_MARK_COMPACT = FALSE,
   DEBUG_MEM = FALSE,
   DEBUG_OBJPTR = FALSE,
+  DEBUG_PARALLEL_GC = FALSE,
   DEBUG_PROFILE = FALSE,
   DEBUG_RESIZING = FALSE,
   DEBUG_SHARE = FALSE,
@@ -36,12 +36,25 @@ static void displayCollectionStats (FILE *out, const char *name, struct rusage *
   fprintf (out, "\n");
 }
 
+static void displayNumaStatistics (GC_state s, FILE *out) {
+  uintmax_t bytes[GC_NUMA_MAX_NODES];
+  int numNodes;
+
+  numNodes = GC_numaNumberOfNodes ();
+  GC_numaNodeBytes (s->heap->start, s->heap->size, bytes, numNodes);
+  for (int node = 0; node < numNodes; node++)
+    fprintf (out, "heap bytes on node %d: %s bytes\n",
+             node, uintmaxToCommaString (bytes[node]));
+}
+
 void GC_done (GC_state s) {
   FILE *out;
 
   s->syncReason = SYNC_FORCE;
   ENTER0 (s);
+  abortConcurrentMark (s);
   minorGC (s);
+  mergeProcessorStatistics (s);
   out = stderr;
   if (s->controls->summary) {
     uintmax_t totalTime;
@@ -136,7 +149,16 @@ void GC_done (GC_state s) {
 
     fprintf (out, "bytes hash consed: %s bytes\n",
              uintmaxToCommaString (s->cumulativeStatistics->bytesHashConsed));
+    fprintf (out, "num parallel gcs: %s\n",
+             uintmaxToCommaString (s->cumulativeStatistics->numParallelGCs));
+    fprintf (out, "num concurrent marks: %s\n",
+             uintmaxToCommaString (s->cumulativeStatistics->numConcurrentMarks));
+    Parallel_displayLockStatistics (s, out);
+    if (s->controls->numa)
+      displayNumaStatistics (s, out);
   }
+  writeEventLogTrace (s);
+  writeHeapProfile (s, "exit");
   releaseHeap (s, s->heap);
   releaseHeap (s, s->secondaryHeap);
 }
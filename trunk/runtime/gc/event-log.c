@@ -0,0 +1,204 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+uint64_t getGCEventTime (void) {
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+void initEventLog (GC_state s) {
+  struct GC_eventLog *log;
+
+  log = (struct GC_eventLog *) malloc_safe (sizeof (struct GC_eventLog));
+  log->events = (struct GC_event *)
+    calloc_safe (GC_EVENT_LOG_LENGTH, sizeof (struct GC_event));
+  log->numEvents = 0;
+  log->startTime = getGCEventTime ();
+  log->syncStart = 0;
+  log->syncTime = 0;
+  log->numTraced = 0;
+  log->trace = NULL;
+  if (NULL != s->controls->gcTrace) {
+    log->trace = fopen_safe (s->controls->gcTrace, "w");
+    fprintf (log->trace,
+             "# number kind proc start_us total_us sync_us roots_us copy_us"
+             " mark_us compact_us resize_us bytes_promoted bytes_live\n");
+  }
+  s->eventLog = log;
+}
+
+/* Called by the first and the last processor to enter a critical
+ * section.
+ */
+void noteSyncStartForEventLog (GC_state s) {
+  s->eventLog->syncStart = getGCEventTime ();
+}
+
+void noteSyncEndForEventLog (GC_state s) {
+  s->eventLog->syncTime = getGCEventTime () - s->eventLog->syncStart;
+}
+
+void beginGCEvent (GC_state s) {
+  struct GC_event *e;
+
+  e = &s->eventLog->current;
+  memset (e, 0, sizeof (struct GC_event));
+  e->kind = GC_EVENT_MINOR;
+  e->procNumber = s->procNumber;
+  e->start = getGCEventTime () - s->eventLog->startTime;
+  e->phaseTime[GC_PHASE_SYNC] = s->eventLog->syncTime;
+  s->eventLog->syncTime = 0;
+}
+
+void setGCEventKind (GC_state s, GC_eventKind kind) {
+  s->eventLog->current.kind = kind;
+  s->eventLog->current.hashCons = s->hashConsDuringGC;
+}
+
+/* Charges the time since since to phase, and returns the time now, so
+ * that consecutive phases can be timed with one read of the clock
+ * each.
+ */
+uint64_t addGCEventPhaseTime (GC_state s, GC_phase phase, uint64_t since) {
+  uint64_t now;
+
+  now = getGCEventTime ();
+  s->eventLog->current.phaseTime[phase] += now - since;
+  return now;
+}
+
+static const char *eventKindToString (GC_eventKind kind) {
+  switch (kind) {
+  case GC_EVENT_MINOR:
+    return "minor";
+  case GC_EVENT_COPYING:
+    return "copying";
+  case GC_EVENT_MARK_COMPACT:
+    return "mark-compact";
+  default:
+    die ("unknown event kind %d", kind);
+  }
+}
+
+static void writeEvent (FILE *f, struct GC_event *e) {
+  fprintf (f, "%"PRIuMAX" %s%s %"PRId32" %"PRIu64,
+           e->number,
+           eventKindToString (e->kind),
+           e->hashCons ? "+hash-cons" : "",
+           e->procNumber,
+           e->start / 1000);
+  for (int phase = 0; phase < GC_NUM_PHASES; phase++)
+    fprintf (f, " %"PRIu64, e->phaseTime[phase] / 1000);
+  fprintf (f, " %"PRIuMAX" %"PRIuMAX"\n",
+           (uintmax_t)e->bytesPromoted, (uintmax_t)e->bytesLive);
+}
+
+/* Writes out every event not yet in the trace.  Called before an
+ * unwritten event would be overwritten, and by GC_done.
+ */
+void writeEventLogTrace (GC_state s) {
+  struct GC_eventLog *log;
+
+  log = s->eventLog;
+  if (NULL == log->trace)
+    return;
+  for (; log->numTraced < log->numEvents; log->numTraced++)
+    writeEvent (log->trace,
+                &log->events[log->numTraced % GC_EVENT_LOG_LENGTH]);
+  fflush (log->trace);
+}
+
+/* Called at the end of performGC with the time it started. */
+void endGCEvent (GC_state s, uint64_t start) {
+  struct GC_eventLog *log;
+  struct GC_event *e;
+  uintmax_t number;
+
+  log = s->eventLog;
+  log->current.bytesLive = s->heap->oldGenSize;
+  log->current.phaseTime[GC_PHASE_TOTAL] =
+    getGCEventTime () - start + log->current.phaseTime[GC_PHASE_SYNC];
+  number = log->numEvents;
+  if (number - log->numTraced == GC_EVENT_LOG_LENGTH)
+    writeEventLogTrace (s);
+  log->current.number = number;
+  e = &log->events[number % GC_EVENT_LOG_LENGTH];
+  e->sequence = 0;
+  __sync_synchronize ();
+  memcpy ((void*)&e->number, (void*)&log->current.number,
+          sizeof (struct GC_event) - offsetof (struct GC_event, number));
+  __sync_synchronize ();
+  e->sequence = number + 1;
+  log->numEvents = number + 1;
+}
+
+uintmax_t GC_getEventLogNumEvents (__attribute__ ((unused)) GC_state *gs) {
+  GC_state s = Proc_getCurrentState ();
+  return s->eventLog->numEvents;
+}
+
+static int compareUint64 (const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/* Returns the given percentile (0.0 to 100.0) of the time in phase
+ * over the logged collections, in nanoseconds, by nearest rank.
+ * Collections that did not go through the phase count as taking no
+ * time in it.
+ */
+uintmax_t GC_getEventLogPercentile (__attribute__ ((unused)) GC_state *gs,
+                                    int32_t phase, double percentile) {
+  GC_state s = Proc_getCurrentState ();
+  struct GC_eventLog *log;
+  uint64_t times[GC_EVENT_LOG_LENGTH];
+  uintmax_t first, last;
+  size_t n;
+  double rank;
+  size_t index;
+
+  if (phase < 0 or phase >= GC_NUM_PHASES)
+    die ("GC_getEventLogPercentile: bad phase %"PRId32, phase);
+  log = s->eventLog;
+  last = log->numEvents;
+  first = last > GC_EVENT_LOG_LENGTH ? last - GC_EVENT_LOG_LENGTH : 0;
+  n = 0;
+  for (uintmax_t i = first; i < last; i++) {
+    struct GC_event *e;
+    uintmax_t sequence;
+    uint64_t time;
+
+    e = &log->events[i % GC_EVENT_LOG_LENGTH];
+    sequence = e->sequence;
+    if (sequence != i + 1)
+      continue;
+    __sync_synchronize ();
+    time = e->phaseTime[phase];
+    __sync_synchronize ();
+    if (e->sequence != sequence)
+      continue;
+    times[n++] = time;
+  }
+  if (0 == n)
+    return 0;
+  qsort (times, n, sizeof (uint64_t), compareUint64);
+  /* The smallest time with at least percentile of them at or below it. */
+  if (percentile <= 0.0)
+    index = 0;
+  else if (percentile >= 100.0)
+    index = n - 1;
+  else {
+    rank = ceil (percentile / 100.0 * (double)n);
+    index = (size_t)rank - 1;
+  }
+  return (uintmax_t)times[min (index, n - 1)];
+}
@@ -0,0 +1,92 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* The event log keeps a record of each of the last
+ * GC_EVENT_LOG_LENGTH collections: what kind it was, how long the
+ * processors took to stop, and how long each phase took.  It is
+ * always on; a collection costs a few more reads of the clock.
+ *
+ * The collector is the only writer.  Readers (the basis, asking for
+ * pause percentiles) don't stop the world, so each entry carries a
+ * sequence number that is cleared while the entry is written and set
+ * once it is complete, and a reader drops any entry whose sequence
+ * number isn't the same before and after it is copied.
+ */
+
+#define GC_EVENT_LOG_LENGTH 1024
+
+typedef enum {
+  GC_EVENT_MINOR,
+  GC_EVENT_COPYING,
+  GC_EVENT_MARK_COMPACT,
+} GC_eventKind;
+
+/* The phases of a collection.  The order matters to the basis, which
+ * refers to them by number; GC_PHASE_TOTAL is the whole pause,
+ * including the sync.
+ */
+typedef enum {
+  GC_PHASE_TOTAL,
+  GC_PHASE_SYNC, /* waiting for the other processors to stop */
+  GC_PHASE_ROOTS, /* forwarding globals, stacks, and intergenerational pointers */
+  GC_PHASE_COPY, /* Cheney scan, major or minor */
+  GC_PHASE_MARK,
+  GC_PHASE_COMPACT, /* threading and sliding */
+  GC_PHASE_RESIZE, /* growing or shrinking the heaps */
+  GC_NUM_PHASES,
+} GC_phase;
+
+struct GC_event {
+  volatile uintmax_t sequence; /* number + 1 once written, 0 while writing */
+  uintmax_t number;
+  GC_eventKind kind;
+  bool hashCons;
+  int32_t procNumber; /* processor that did the collection */
+  uint64_t start; /* nanoseconds since the log was created */
+  uint64_t phaseTime[GC_NUM_PHASES]; /* nanoseconds */
+  size_t bytesPromoted; /* by the minor GC */
+  size_t bytesLive; /* old generation at the end */
+};
+
+struct GC_eventLog {
+  struct GC_event *events; /* GC_EVENT_LOG_LENGTH entries */
+  volatile uintmax_t numEvents; /* ever recorded */
+  struct GC_event current; /* the collection in progress */
+  uint64_t startTime;
+  uint64_t syncStart;
+  uint64_t syncTime; /* of the last rendezvous, not yet charged to a GC */
+  FILE *trace; /* NULL unless gc-trace was given */
+  uintmax_t numTraced; /* events already written to trace */
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static inline uint64_t getGCEventTime (void);
+static void initEventLog (GC_state s);
+static inline void noteSyncStartForEventLog (GC_state s);
+static inline void noteSyncEndForEventLog (GC_state s);
+static void beginGCEvent (GC_state s);
+static inline void setGCEventKind (GC_state s, GC_eventKind kind);
+static inline uint64_t addGCEventPhaseTime (GC_state s, GC_phase phase,
+                                            uint64_t since);
+static void endGCEvent (GC_state s, uint64_t start);
+static void writeEventLogTrace (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
+
+#if (defined (MLTON_GC_INTERNAL_BASIS))
+
+PRIVATE uintmax_t GC_getEventLogNumEvents (GC_state *gs);
+PRIVATE uintmax_t GC_getEventLogPercentile (GC_state *gs, int32_t phase,
+                                            double percentile);
+
+#endif /* (defined (MLTON_GC_INTERNAL_BASIS)) */
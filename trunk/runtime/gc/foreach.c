@@ -6,9 +6,18 @@
  * See the file MLton-LICENSE for details.
  */
 
+/* callIfIsObjptr (s, f, opp)
+ *
+ * Pinned buffers are never moved, so f isn't applied to pointers to
+ * them; they are marked instead.
+ */
 void callIfIsObjptr (GC_state s, GC_foreachObjptrFun f, objptr *opp) {
-  if (isObjptr (*opp))
-    f (s, opp);
+  if (isObjptr (*opp)) {
+    if (isObjptrPinned (s, *opp))
+      markPinnedObjptr (s, *opp);
+    else
+      f (s, opp);
+  }
 }
 
 /* foreachGlobalObjptr (s, f)
@@ -24,18 +33,8 @@ void foreachGlobalObjptr (GC_state s, GC_foreachObjptrFun f) {
   if (DEBUG_DETAILED)
     fprintf (stderr, "foreachGlobal threads\n");
   if (s->procStates) {
-    for (int proc = 0; proc < s->numberOfProcs; proc++) {
-      callIfIsObjptr (s, f, &s->procStates[proc].callFromCHandlerThread);
-      callIfIsObjptr (s, f, &s->procStates[proc].currentThread);
-      callIfIsObjptr (s, f, &s->procStates[proc].savedThread);
-      callIfIsObjptr (s, f, &s->procStates[proc].signalHandlerThread);
-
-      if (s->procStates[proc].roots) {
-        for (uint32_t i = 0; i < s->procStates[proc].rootsLength; i++) {
-          callIfIsObjptr (s, f, &s->procStates[proc].roots[i]);
-        }
-      }
-    }
+    for (int proc = 0; proc < s->numberOfProcs; proc++)
+      foreachProcessorObjptr (s, &s->procStates[proc], f);
   }
   else {
     callIfIsObjptr (s, f, &s->callFromCHandlerThread);
@@ -45,6 +44,21 @@ void foreachGlobalObjptr (GC_state s, GC_foreachObjptrFun f) {
   }
 }
 
+/* foreachProcessorObjptr (s, p, f)
+ *
+ * Apply f to each object pointer held by the processor whose state is
+ * p: its threads and any roots on its C call stack.
+ */
+void foreachProcessorObjptr (GC_state s, GC_state p, GC_foreachObjptrFun f) {
+  callIfIsObjptr (s, f, &p->callFromCHandlerThread);
+  callIfIsObjptr (s, f, &p->currentThread);
+  callIfIsObjptr (s, f, &p->savedThread);
+  callIfIsObjptr (s, f, &p->signalHandlerThread);
+  if (p->roots) {
+    for (uint32_t i = 0; i < p->rootsLength; i++)
+      callIfIsObjptr (s, f, &p->roots[i]);
+  }
+}
 
 /* foreachObjptrInObject (s, p, f, skipWeaks)
  *
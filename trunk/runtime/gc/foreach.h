@@ -16,6 +16,12 @@ static inline void callIfIsObjptr (GC_state s, GC_foreachObjptrFun f, objptr *op
  * Apply f to each global object pointer into the heap.
  */
 static inline void foreachGlobalObjptr (GC_state s, GC_foreachObjptrFun f);
+/* foreachProcessorObjptr (s, p, f)
+ *
+ * Apply f to each object pointer held by the processor whose state is p.
+ */
+static inline void foreachProcessorObjptr (GC_state s, GC_state p,
+                                           GC_foreachObjptrFun f);
 /* foreachObjptrInObject (s, p, skipWeaks, f)
  *
  * Applies f to each object pointer in the object pointed to by p.
@@ -146,8 +146,10 @@ void forwardObjptrIfInNursery (GC_state s, objptr *opp) {
   forwardObjptr (s, opp);
 }
 
-/* Walk through all the cards and forward all intergenerational pointers. */
-void forwardInterGenerationalObjptrs (GC_state s) {
+/* Walk through all the cards and forward all intergenerational pointers
+ * using f, which is forwardObjptrIfInNursery unless copying in parallel.
+ */
+void forwardInterGenerationalObjptrs (GC_state s, GC_foreachObjptrFun f) {
   GC_cardMapElem *cardMap;
   GC_crossMapElem *crossMap;
   pointer oldGenStart, oldGenEnd;
@@ -198,8 +200,7 @@ checkCard:
      * Weak.set, the foreachObjptrInRange will do the right thing on
      * weaks, since the weak pointer will never be into the nursery.
      */
-    objectStart = foreachObjptrInRange (s, objectStart, &cardEnd,
-                                        forwardObjptrIfInNursery, FALSE);
+    objectStart = foreachObjptrInRange (s, objectStart, &cardEnd, f, FALSE);
     s->cumulativeStatistics->bytesScannedMinor += objectStart - lastObject;
     if (objectStart == oldGenEnd)
       goto done;
@@ -25,6 +25,7 @@ static inline bool isPointerInToSpace (GC_state s, pointer p);
 static inline bool isObjptrInToSpace (GC_state s, objptr op);
 static inline void forwardObjptr (GC_state s, objptr *opp);
 static inline void forwardObjptrIfInNursery (GC_state s, objptr *opp);
-static inline void forwardInterGenerationalObjptrs (GC_state s);
+static inline void forwardInterGenerationalObjptrs (GC_state s,
+                                                    GC_foreachObjptrFun f);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
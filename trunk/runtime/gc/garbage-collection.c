@@ -7,12 +7,14 @@
  */
 
 void minorGC (GC_state s) {
+  mergeHeapProfileBuffers (s);
   minorCheneyCopyGC (s);
 }
 
 void majorGC (GC_state s, size_t bytesRequested, bool mayResize) {
   uintmax_t numGCs;
   size_t desiredSize;
+  uint64_t phaseStart;
 
   s->lastMajorStatistics->numMinorGCs = 0;
   numGCs =
@@ -22,10 +24,17 @@ void majorGC (GC_state s, size_t bytesRequested, bool mayResize) {
       and ((float)(s->cumulativeStatistics->numHashConsGCs) / (float)(numGCs)
            < s->controls->ratios.hashCons))
     s->hashConsDuringGC = TRUE;
+  /* Use the marking done in the background. */
+  if (isConcurrentMarkRunning ())
+    s->hashConsDuringGC = FALSE;
+  /* A concurrent mark has already marked buffers since it started. */
+  unless (isConcurrentMarkRunning ())
+    clearPinnedMarks ();
   desiredSize =
     sizeofHeapDesired (s, s->lastMajorStatistics->bytesLive + bytesRequested, 0);
   if (not FORCE_MARK_COMPACT
       and not s->hashConsDuringGC // only markCompact can hash cons
+      and not isConcurrentMarkRunning ()
       and s->heap->size < s->sysvals.ram
       and (not isHeapInit (s->secondaryHeap)
            or createHeapSecondary (s, desiredSize)))
@@ -33,19 +42,23 @@ void majorGC (GC_state s, size_t bytesRequested, bool mayResize) {
   else
     majorMarkCompactGC (s);
   s->hashConsDuringGC = FALSE;
+  sweepPinned (s);
   s->lastMajorStatistics->bytesLive = s->heap->oldGenSize;
   if (s->lastMajorStatistics->bytesLive > s->cumulativeStatistics->maxBytesLive)
     s->cumulativeStatistics->maxBytesLive = s->lastMajorStatistics->bytesLive;
+  writeHeapProfile (s, "major gc");
   /* Notice that the s->lastMajorStatistics->bytesLive below is
    * different than the s->lastMajorStatistics->bytesLive used as an
    * argument to createHeapSecondary above.  Above, it was an
    * estimate.  Here, it is exactly how much was live after the GC.
    */
+  phaseStart = getGCEventTime ();
   if (mayResize) {
     resizeHeap (s, s->lastMajorStatistics->bytesLive + bytesRequested);
     setCardMapAndCrossMap (s);
   }
   resizeHeapSecondary (s);
+  addGCEventPhaseTime (s, GC_PHASE_RESIZE, phaseStart);
   assert (s->heap->oldGenSize + bytesRequested <= s->heap->size);
 }
 
@@ -100,9 +113,11 @@ void performGC (GC_state s,
   bool stackTopOk;
   size_t stackBytesRequested;
   struct timeval tv_start;
+  uint64_t eventStart;
   size_t totalBytesRequested;
 
   enterGC (s);
+  mergeProcessorStatistics (s);
   s->cumulativeStatistics->numGCs++;
   if (DEBUG or s->controls->messages) {
     size_t nurserySize = s->heap->size - (s->heap->nursery - s->heap->start);
@@ -133,6 +148,8 @@ void performGC (GC_state s,
   assert (invariantForGC (s));
   if (needGCTime (s))
     startWallTiming (&tv_start);
+  eventStart = getGCEventTime ();
+  beginGCEvent (s);
   minorGC (s);
   stackTopOk = invariantForMutatorStack (s);
   stackBytesRequested =
@@ -169,6 +186,9 @@ void performGC (GC_state s,
     s->procStates[proc].generationalMaps = s->generationalMaps;
     setGCStateCurrentThreadAndStack (&s->procStates[proc]);
   }
+  unless (forceMajor)
+    maybeStartConcurrentMark (s);
+  endGCEvent (s, eventStart);
   if (needGCTime (s)) {
     gcTime = stopWallTiming (&tv_start, &s->cumulativeStatistics->ru_gc);
     s->cumulativeStatistics->maxPauseTime =
@@ -484,10 +504,11 @@ void GC_collect (GC_state s, size_t bytesRequested, bool force,
   getThreadCurrent(s)->exnStack = s->exnStack;
   getThreadCurrent(s)->bytesNeeded = bytesRequested;
 
-
+  noteAllocationForHeapProfile (s);
   ensureHasHeapBytesFreeAndOrInvariantForMutator (s, force,
                                                   TRUE, TRUE,
                                                   0, 0, TRUE, FALSE);
+  maybeSampleAllocationForHeapProfile (s);
 }
 
 pointer FFI_getOpArgsResPtr (GC_state s) {
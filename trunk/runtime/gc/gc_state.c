@@ -62,6 +62,7 @@ void setGCStateCurrentHeap (GC_state s,
   size_t genNurserySize;
   pointer limit;
   pointer frontier;
+  size_t privateNurserySize;
   size_t bonus = GC_BONUS_SLOP * s->numberOfProcs;
 
   if (not duringInit) {
@@ -109,6 +110,7 @@ void setGCStateCurrentHeap (GC_state s,
     s->canMinor = TRUE;
     nursery = genNursery;
     nurserySize = genNurserySize;
+    saveCardMapForConcurrentMark (s);
     clearCardMap (s);
     /* XXX copy card map to other processors? */
   } else {
@@ -183,12 +185,22 @@ void setGCStateCurrentHeap (GC_state s,
   frontier = nursery;
 
   if (not duringInit) {
+    /* Beyond what its current thread needs, each processor gets an
+     * equal share of the rest of the nursery to allocate from.  It is
+     * still collected by the global minor GC.
+     */
+    privateNurserySize =
+      (size_t)(s->controls->ratios.privateNursery
+               * (double)((nurserySize - nurseryBytesRequested)
+                          / (size_t)s->numberOfProcs));
+    privateNurserySize = alignDown (privateNurserySize, s->alignment);
     for (int proc = 0; proc < s->numberOfProcs; proc++) {
       s->procStates[proc].canMinor = s->canMinor;
       assert (isFrontierAligned (s, frontier));
       s->procStates[proc].start = s->procStates[proc].frontier = frontier;
       s->procStates[proc].limitPlusSlop = s->procStates[proc].start +
-        getThreadCurrent(&s->procStates[proc])->bytesNeeded;
+        getThreadCurrent(&s->procStates[proc])->bytesNeeded +
+        privateNurserySize;
       s->procStates[proc].limit = s->procStates[proc].limitPlusSlop - GC_HEAP_LIMIT_SLOP;
       assert (s->procStates[proc].frontier <= s->procStates[proc].limitPlusSlop);
       /* XXX clearCardMap (?) */
@@ -199,6 +211,20 @@ void setGCStateCurrentHeap (GC_state s,
 
       frontier = s->procStates[proc].limitPlusSlop + GC_BONUS_SLOP;
     }
+    /* Move each private nursery to its processor's node.  Pages that
+     * are already there are left alone.  The shared remainder is
+     * dropped, so that each of its pages lands on the node of the
+     * processor that claims and first touches it.
+     */
+    if (s->controls->numa) {
+      for (int proc = 0; proc < s->numberOfProcs; proc++)
+        GC_numaPrefer (s->procStates[proc].start,
+                       (size_t)(s->procStates[proc].limitPlusSlop
+                                - s->procStates[proc].start),
+                       s->procStates[proc].numaNode);
+      if (frontier < limit)
+        GC_numaFirstTouch (frontier, (size_t)(limit - frontier));
+    }
   }
   else {
     assert (Proc_processorNumber (s) == 0);
@@ -278,7 +304,7 @@ void GC_setControlsRusageMeasureGC (__attribute__ ((unused)) GC_state *gs, bool
 
 uintmax_t GC_getCumulativeStatisticsBytesAllocated (__attribute__ ((unused)) GC_state *gs) {
   GC_state s = pthread_getspecific (gcstate_key);
-  return s->cumulativeStatistics->bytesAllocated;
+  return getBytesAllocated (s);
 }
 
 uintmax_t GC_getCumulativeStatisticsNumCopyingGCs (__attribute__ ((unused)) GC_state *gs) {
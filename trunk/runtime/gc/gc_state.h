@@ -20,6 +20,10 @@ struct GC_state {
   size_t exnStack;
   /* Alphabetized fields follow. */
   size_t alignment; /* */
+  /* TRUE while this processor helps another's collection, from the
+   * rendezvous, so that the profiler charges its time to the GC.
+   */
+  bool amHelpingGC;
   bool amInGC;
   bool amOriginal;
   char **atMLtons; /* Initial @MLton args, processed before command line. */
@@ -31,6 +35,7 @@ struct GC_state {
   struct GC_controls *controls;
   struct GC_cumulativeStatistics *cumulativeStatistics;
   objptr currentThread; /* Currently executing thread (in heap). */
+  struct GC_eventLog *eventLog;
   struct GC_forwardState forwardState;
   pointer ffiOpArgsResPtr;
   GC_frameLayout frameLayouts; /* Array of frame layouts. */
@@ -43,6 +48,8 @@ struct GC_state {
   uint32_t globalsLength;
   bool hashConsDuringGC;
   struct GC_heap *heap;
+  struct GC_heapProfile *heapProfile;
+  struct GC_heapProfileBuffer heapProfileBuffer;
   struct GC_intInfInit *intInfInits;
   uint32_t intInfInitsLength;
   struct GC_lastMajorStatistics *lastMajorStatistics;
@@ -62,8 +69,11 @@ struct GC_state {
   GC_objectHashTable objectHashTable;
   GC_objectType objectTypes; /* Array of object types. */
   uint32_t objectTypesLength; /* Cardinality of objectTypes array. */
+  int32_t procNumber; /* Index of this state in procStates. */
+  int32_t numaNode; /* Node of the cpu we are pinned to, or -1. */
   /* States for each processor */
   GC_state procStates;
+  struct GC_processorStatistics procStatistics;
   struct GC_profiling profiling;
   GC_frameIndex (*returnAddressToFrameIndex) (GC_returnAddress ra);
   uint32_t returnToC;
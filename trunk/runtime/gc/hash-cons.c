@@ -95,20 +95,50 @@ void freeHashTable (GC_objectHashTable t) {
   free (t);
 }
 
+/* The multiplier is (sqrt(5) - 1) / 2 scaled to 32 bits. */
+uint32_t getHashTableSlot (GC_objectHashTable t, GC_hash hash) {
+  return (uint32_t)(UINT64_C(0x9E3779B9) * (uint64_t)hash)
+    >> (32 - t->elementsLengthMaxLog2);
+}
+
+/* Compares object to other, which has the same hash; max is the end
+ * of object.
+ */
+bool isObjectEqualForHashCons (GC_state s, pointer object, pointer other,
+                               pointer max) {
+  GC_header header;
+  GC_objectTypeTag tag;
+  unsigned int *p1;
+  unsigned int *p2;
+
+  if (object == other)
+    return TRUE;
+  header = getHeader (object);
+  unless (header == getHeader (other))
+    return FALSE;
+  for (p1 = (unsigned int*)object,
+       p2 = (unsigned int*)other;
+       p1 < (unsigned int*)max;
+       ++p1, ++p2)
+    unless (*p1 == *p2)
+      return FALSE;
+  splitHeader (s, header, &tag, NULL, NULL, NULL);
+  if (ARRAY_TAG == tag
+      and (getArrayLength (object) != getArrayLength (other)))
+    return FALSE;
+  return TRUE;
+}
+
 pointer insertHashTableElem (__attribute__ ((unused)) GC_state s,
                              GC_objectHashTable t,
                              GC_hash hash, pointer object,
                              pointer max, bool mightBeThere) {
-  static bool init = FALSE;
-  static uint64_t mult; // magic multiplier for hashing
   static uint32_t maxNumProbes = 0;
 
   GC_objectHashElement e;
   uint32_t numProbes;
   uint32_t probe;
   uint32_t slot; // slot in the hash table we are considering
-  unsigned int *p1;
-  unsigned int *p2;
 
   if (DEBUG_SHARE)
     fprintf (stderr, "insertHashTableElem ("FMTHASH", "FMTPTR", "FMTPTR", %s)\n",
@@ -116,12 +146,7 @@ pointer insertHashTableElem (__attribute__ ((unused)) GC_state s,
              (uintptr_t)object,
              (uintptr_t)max,
              boolToString (mightBeThere));
-  if (! init) {
-    init = TRUE;
-    mult = floor (((sqrt (5.0) - 1.0) / 2.0)
-                  * (double)0x100000000llu);
-  }
-  slot = (uint32_t)(mult * (uint64_t)hash) >> (32 - t->elementsLengthMaxLog2);
+  slot = getHashTableSlot (t, hash);
   probe = (1 == slot % 2) ? slot : slot - 1;
   if (DEBUG_SHARE)
     fprintf (stderr, "probe = 0x%"PRIx32"\n", probe);
@@ -160,37 +185,70 @@ lookNext:
   if (DEBUG_SHARE)
     fprintf (stderr, "comparing "FMTPTR" to "FMTPTR"\n",
              (uintptr_t)object, (uintptr_t)e->object);
-  /* Compare object to e->object. */
-  unless (object == e->object) {
-    GC_header header;
-    GC_objectTypeTag tag;
-
-    header = getHeader (object);
-    unless (header == getHeader (e->object))
-      goto lookNext;
-    for (p1 = (unsigned int*)object,
-         p2 = (unsigned int*)e->object;
-         p1 < (unsigned int*)max;
-         ++p1, ++p2)
-      unless (*p1 == *p2)
-        goto lookNext;
-    splitHeader (s, header, &tag, NULL, NULL, NULL);
-    if (ARRAY_TAG == tag
-        and (getArrayLength (object) != getArrayLength (e->object)))
-      goto lookNext;
-  }
+  unless (isObjectEqualForHashCons (s, object, e->object, max))
+    goto lookNext;
   /* object is equal to e->object. */
   return e->object;
 }
 
-void growHashTableMaybe (GC_state s, GC_objectHashTable t) {
+/* Like insertHashTableElem (with mightBeThere), except that several
+ * processors may insert at once.  An empty slot is claimed by swapping
+ * its object from NULL to GC_HASH_BUSY; the winner then fills in the
+ * hash and publishes the object.  Anyone else probing the slot waits
+ * for the object, so two equal objects can't both be inserted: they
+ * follow the same probe sequence, and the later one finds the earlier
+ * in the first slot that either of them claimed.  The table can't
+ * grow, so it stops taking new objects once it is half full.
+ */
+pointer insertHashTableElemInParallel (GC_state s, GC_objectHashTable t,
+                                       GC_hash hash, pointer object,
+                                       pointer max) {
+  GC_objectHashElement e;
+  pointer other;
+  uint32_t probe;
+  uint32_t slot;
+
+  slot = getHashTableSlot (t, hash);
+  probe = (1 == slot % 2) ? slot : slot - 1;
+look:
+  assert (slot < t->elementsLengthMax);
+  e = &t->elements[slot];
+  other = e->object;
+  if (NULL == other) {
+    unless (t->mayInsert)
+      return object;
+    if (t->elementsLengthCur * 2 > t->elementsLengthMax) {
+      t->mayInsert = FALSE;
+      return object;
+    }
+    unless (__sync_bool_compare_and_swap (&e->object, NULL, GC_HASH_BUSY))
+      goto look;
+    e->hash = hash;
+    __sync_synchronize ();
+    e->object = object;
+    __sync_fetch_and_add (&t->elementsLengthCur, 1);
+    return object;
+  }
+  /* The barriers make us read the slot again, and read its hash after
+   * its object.
+   */
+  __sync_synchronize ();
+  if (GC_HASH_BUSY == other)
+    goto look;
+  if (hash == e->hash
+      and isObjectEqualForHashCons (s, object, other, max))
+    return other;
+  slot = (slot + probe) % t->elementsLengthMax;
+  goto look;
+}
+
+/* Doubles the size of the table, or clears mayInsert if it can't. */
+void growHashTable (GC_state s, GC_objectHashTable t) {
   GC_objectHashElement oldElement;
   struct GC_objectHashElement *oldElements;
   uint32_t oldElementsLengthMax;
   uint32_t newElementsLengthMax;
 
-  if (not t->mayInsert or t->elementsLengthCur * 2 <= t->elementsLengthMax)
-    return;
   oldElements = t->elements;
   oldElementsLengthMax = t->elementsLengthMax;
   newElementsLengthMax = oldElementsLengthMax * 2;
@@ -225,8 +283,28 @@ void growHashTableMaybe (GC_state s, GC_objectHashTable t) {
     fprintf (stderr, "done growing table\n");
 }
 
-pointer hashConsPointer (GC_state s, pointer object, bool countBytesHashConsed) {
-  GC_objectHashTable t;
+void growHashTableMaybe (GC_state s, GC_objectHashTable t) {
+  if (not t->mayInsert or t->elementsLengthCur * 2 <= t->elementsLengthMax)
+    return;
+  growHashTable (s, t);
+}
+
+/* Grow the table ahead of time so that it can hold numElements, since
+ * it can't grow while processors are inserting in parallel.
+ */
+void reserveHashTable (GC_state s, GC_objectHashTable t, size_t numElements) {
+  while (t->mayInsert
+         and (size_t)t->elementsLengthMax < 2 * numElements
+         and t->elementsLengthMaxLog2 < 31)
+    growHashTable (s, t);
+}
+
+/* Computes the hash of object and returns a pointer just past its
+ * contents, or NULL if object has identity and so can't be hash
+ * consed.  *sizep is set to the size of object, including its header.
+ */
+pointer hashObjectForHashCons (GC_state s, pointer object,
+                               GC_hash *hashp, size_t *sizep) {
   GC_header header;
   uint16_t bytesNonObjptrs;
   uint16_t numObjptrs;
@@ -235,18 +313,12 @@ pointer hashConsPointer (GC_state s, pointer object, bool countBytesHashConsed)
   pointer max;
   GC_hash hash;
   GC_hash* p;
-  pointer res;
 
-  if (DEBUG_SHARE)
-    fprintf (stderr, "hashConsPointer ("FMTPTR")\n", (uintptr_t)object);
-  t = s->objectHashTable;
   header = getHeader (object);
   splitHeader(s, header, &tag, &hasIdentity, &bytesNonObjptrs, &numObjptrs);
-  if (hasIdentity) {
-    /* Don't hash cons. */
-    res = object;
-    goto done;
-  }
+  /* A pinned buffer has the header of a vector, but it is mutable. */
+  if (hasIdentity or isPointerPinned (object))
+    return NULL;
   assert ((ARRAY_TAG == tag) or (NORMAL_TAG == tag));
   max =
     object
@@ -258,19 +330,33 @@ pointer hashConsPointer (GC_state s, pointer object, bool countBytesHashConsed)
   hash = (GC_hash)header;
   for (p = (GC_hash*)object; p < (GC_hash*)max; ++p)
     hash = hash * 31 + *p;
+  *hashp = hash;
+  *sizep = (max - object)
+    + (ARRAY_TAG == tag ? GC_ARRAY_HEADER_SIZE : GC_NORMAL_HEADER_SIZE);
+  return max;
+}
+
+pointer hashConsPointer (GC_state s, pointer object, bool countBytesHashConsed) {
+  GC_objectHashTable t;
+  pointer max;
+  GC_hash hash;
+  size_t size;
+  pointer res;
+
+  if (DEBUG_SHARE)
+    fprintf (stderr, "hashConsPointer ("FMTPTR")\n", (uintptr_t)object);
+  t = s->objectHashTable;
+  max = hashObjectForHashCons (s, object, &hash, &size);
+  if (NULL == max) {
+    /* Don't hash cons. */
+    res = object;
+    goto done;
+  }
   /* Insert into table. */
   res = insertHashTableElem (s, t, hash, object, max, TRUE);
   growHashTableMaybe (s, t);
-  if (countBytesHashConsed and res != object) {
-    size_t amount;
-
-    amount = max - object;
-    if (ARRAY_TAG == tag)
-      amount += GC_ARRAY_HEADER_SIZE;
-    else
-      amount += GC_NORMAL_HEADER_SIZE;
-    s->lastMajorStatistics->bytesHashConsed += amount;
-  }
+  if (countBytesHashConsed and res != object)
+    s->lastMajorStatistics->bytesHashConsed += size;
 done:
   if (DEBUG_SHARE)
     fprintf (stderr, FMTPTR" = hashConsPointer ("FMTPTR")\n",
@@ -278,6 +364,26 @@ done:
   return res;
 }
 
+/* Like hashConsPointer, but for use by several processors at once on
+ * a table that has been reserved for them.  Adds the size of object
+ * to *bytesHashConsed if it is replaced.
+ */
+pointer hashConsPointerInParallel (GC_state s, GC_objectHashTable t,
+                                   pointer object, size_t *bytesHashConsed) {
+  pointer max;
+  GC_hash hash;
+  size_t size;
+  pointer res;
+
+  max = hashObjectForHashCons (s, object, &hash, &size);
+  if (NULL == max)
+    return object;
+  res = insertHashTableElemInParallel (s, t, hash, object, max);
+  if (res != object)
+    *bytesHashConsed += size;
+  return res;
+}
+
 void shareObjptr (GC_state s, objptr *opp) {
   pointer p;
 
@@ -31,6 +31,11 @@ typedef struct GC_objectHashTable {
   bool mayInsert;
 } *GC_objectHashTable;
 
+/* Marks a slot that a processor has claimed but not yet filled in.
+ * It is never a valid object pointer.
+ */
+#define GC_HASH_BUSY ((pointer)1)
+
 #endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
 
 #if (defined (MLTON_GC_INTERNAL_FUNCS))
@@ -38,12 +43,24 @@ typedef struct GC_objectHashTable {
 static inline GC_objectHashTable allocHashTable (GC_state s);
 static inline void freeHashTable (GC_objectHashTable t);
 
+static inline uint32_t getHashTableSlot (GC_objectHashTable t, GC_hash hash);
+static inline bool isObjectEqualForHashCons (GC_state s, pointer object,
+                                             pointer other, pointer max);
 static inline pointer insertHashTableElem (GC_state s, 
                                            GC_objectHashTable t, GC_hash hash, 
                                            pointer object, pointer max, bool mightBeThere);
+static pointer insertHashTableElemInParallel (GC_state s, GC_objectHashTable t,
+                                              GC_hash hash, pointer object,
+                                              pointer max);
+static void growHashTable (GC_state s, GC_objectHashTable t);
 static inline void growHashTableMaybe (GC_state s, GC_objectHashTable t);
+static void reserveHashTable (GC_state s, GC_objectHashTable t, size_t numElements);
 
+static inline pointer hashObjectForHashCons (GC_state s, pointer object,
+                                             GC_hash *hashp, size_t *sizep);
 static pointer hashConsPointer (GC_state s, pointer object, bool countBytesHashConsed);
+static pointer hashConsPointerInParallel (GC_state s, GC_objectHashTable t,
+                                          pointer object, size_t *bytesHashConsed);
 static inline void shareObjptr (GC_state s, objptr *opp);
 
 static void printBytesHashConsedMessage (size_t bytesHashConsed, size_t bytesExamined);
@@ -0,0 +1,352 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+void initHeapProfile (GC_state s) {
+  struct GC_heapProfile *h;
+
+  h = (struct GC_heapProfile *) malloc_safe (sizeof (struct GC_heapProfile));
+  h->sites = NULL;
+  h->sitesLength = 0;
+  h->sitesSize = 0;
+  h->samples = NULL;
+  h->samplesLength = 0;
+  h->samplesSize = 0;
+  h->out = NULL;
+  h->numWritten = 0;
+  s->heapProfile = h;
+}
+
+void initHeapProfileBuffer (GC_state s) {
+  struct GC_heapProfileBuffer *b;
+
+  b = &s->heapProfileBuffer;
+  b->bytesSinceSample = 0;
+  b->lastFrontier = NULL;
+  b->pending = NULL;
+  b->samples = NULL;
+  b->samplesLength = 0;
+  b->samplesSize = 0;
+  b->frames = NULL;
+  b->framesLength = 0;
+  b->framesSize = 0;
+}
+
+/* If the object of the last sample has been allocated, remember it. */
+static void resolveHeapProfilePending (GC_state s, GC_state p) {
+  struct GC_heapProfileBuffer *b;
+
+  b = &p->heapProfileBuffer;
+  if (NULL == b->pending)
+    return;
+  assert (0 < b->samplesLength);
+  if (p->start <= b->pending and b->pending < p->frontier)
+    b->samples[b->samplesLength - 1].object =
+      pointerToObjptr (advanceToObjectData (s, b->pending), s->heap->start);
+  b->pending = NULL;
+}
+
+/* Called by GC_collect before it gets the mutator another chunk, to
+ * count what the mutator allocated in the one it used up.
+ */
+void noteAllocationForHeapProfile (GC_state s) {
+  struct GC_heapProfileBuffer *b;
+
+  if (0 == s->controls->allocSampleBytes)
+    return;
+  b = &s->heapProfileBuffer;
+  resolveHeapProfilePending (s, s);
+  if (NULL != b->lastFrontier
+      and s->start <= b->lastFrontier
+      and b->lastFrontier <= s->frontier)
+    b->bytesSinceSample += s->frontier - b->lastFrontier;
+  else
+    b->bytesSinceSample += s->frontier - s->start;
+}
+
+static void addHeapProfileFrame (GC_state s, GC_frameIndex i) {
+  struct GC_heapProfileBuffer *b;
+
+  b = &s->heapProfileBuffer;
+  if (b->framesLength - b->samples[b->samplesLength - 1].firstFrame
+      >= GC_HEAP_PROFILE_MAX_FRAMES)
+    return;
+  if (b->framesLength == b->framesSize) {
+    b->framesSize = (0 == b->framesSize) ? 1024 : 2 * b->framesSize;
+    b->frames = (GC_frameIndex *)
+      realloc_safe (b->frames, b->framesSize * sizeof (GC_frameIndex));
+  }
+  b->frames[b->framesLength++] = i;
+}
+
+/* Called by GC_collect once the mutator has its chunk. */
+void maybeSampleAllocationForHeapProfile (GC_state s) {
+  struct GC_heapProfileBuffer *b;
+  struct GC_heapProfileBufferSample *sample;
+
+  if (0 == s->controls->allocSampleBytes)
+    return;
+  b = &s->heapProfileBuffer;
+  b->lastFrontier = s->frontier;
+  if (b->bytesSinceSample < s->controls->allocSampleBytes)
+    return;
+  if (b->samplesLength == b->samplesSize) {
+    b->samplesSize = (0 == b->samplesSize) ? 64 : 2 * b->samplesSize;
+    b->samples = (struct GC_heapProfileBufferSample *)
+      realloc_safe (b->samples,
+                    b->samplesSize * sizeof (struct GC_heapProfileBufferSample));
+  }
+  sample = &b->samples[b->samplesLength++];
+  sample->object = BOGUS_OBJPTR;
+  sample->bytes = b->bytesSinceSample;
+  sample->firstFrame = b->framesLength;
+  foreachStackFrame (s, addHeapProfileFrame);
+  sample->numFrames = b->framesLength - sample->firstFrame;
+  b->bytesSinceSample = 0;
+  /* The mutator allocates the object it asked for at the frontier. */
+  b->pending = s->frontier;
+}
+
+static uint32_t hashHeapProfileFrames (GC_frameIndex *frames, uint32_t numFrames) {
+  uint32_t hash;
+
+  hash = 2166136261U;
+  for (uint32_t i = 0; i < numFrames; i++)
+    hash = (hash ^ frames[i]) * 16777619U;
+  return hash;
+}
+
+static uint32_t getHeapProfileSite (GC_state s, GC_frameIndex *frames,
+                                    uint32_t numFrames) {
+  struct GC_heapProfile *h;
+  struct GC_heapProfileSite *site;
+  uint32_t hash;
+
+  h = s->heapProfile;
+  hash = hashHeapProfileFrames (frames, numFrames);
+  for (uint32_t i = 0; i < h->sitesLength; i++) {
+    site = &h->sites[i];
+    if (site->hash == hash
+        and site->numFrames == numFrames
+        and 0 == memcmp (site->frames, frames,
+                         numFrames * sizeof (GC_frameIndex)))
+      return i;
+  }
+  if (h->sitesLength == h->sitesSize) {
+    h->sitesSize = (0 == h->sitesSize) ? 64 : 2 * h->sitesSize;
+    h->sites = (struct GC_heapProfileSite *)
+      realloc_safe (h->sites, h->sitesSize * sizeof (struct GC_heapProfileSite));
+  }
+  site = &h->sites[h->sitesLength];
+  site->hash = hash;
+  site->numFrames = numFrames;
+  /* Never ask malloc for nothing, which it may refuse. */
+  site->frames = (GC_frameIndex *)
+    malloc_safe (max (numFrames, (uint32_t)1) * sizeof (GC_frameIndex));
+  memcpy (site->frames, frames, numFrames * sizeof (GC_frameIndex));
+  site->numSampled = 0;
+  site->bytesSampled = 0;
+  site->numLive = 0;
+  site->bytesLive = 0;
+  return h->sitesLength++;
+}
+
+static void addHeapProfileSample (GC_state s, objptr object, size_t bytes,
+                                  uint32_t site) {
+  struct GC_heapProfile *h;
+  struct GC_heapProfileSample *sample;
+
+  h = s->heapProfile;
+  if (h->samplesLength == h->samplesSize) {
+    h->samplesSize = (0 == h->samplesSize) ? 64 : 2 * h->samplesSize;
+    h->samples = (struct GC_heapProfileSample *)
+      realloc_safe (h->samples,
+                    h->samplesSize * sizeof (struct GC_heapProfileSample));
+  }
+  sample = &h->samples[h->samplesLength++];
+  sample->object = object;
+  sample->bytes = bytes;
+  sample->site = site;
+}
+
+/* Must be called with the world stopped, before anything moves. */
+void mergeHeapProfileBuffers (GC_state s) {
+  int32_t n;
+
+  n = max (1, numberOfStatisticsStates (s));
+  for (int32_t proc = 0; proc < n; proc++) {
+    GC_state p;
+    struct GC_heapProfileBuffer *b;
+
+    p = (NULL == s->procStates) ? s : &s->procStates[proc];
+    b = &p->heapProfileBuffer;
+    resolveHeapProfilePending (s, p);
+    for (uint32_t i = 0; i < b->samplesLength; i++) {
+      struct GC_heapProfileBufferSample *sample;
+      uint32_t site;
+
+      sample = &b->samples[i];
+      site = getHeapProfileSite (s, &b->frames[sample->firstFrame],
+                                 sample->numFrames);
+      s->heapProfile->sites[site].numSampled++;
+      s->heapProfile->sites[site].bytesSampled += sample->bytes;
+      if (BOGUS_OBJPTR != sample->object)
+        addHeapProfileSample (s, sample->object, sample->bytes, site);
+    }
+    b->samplesLength = 0;
+    b->framesLength = 0;
+    /* The GC will hand out new chunks. */
+    b->lastFrontier = NULL;
+  }
+}
+
+void foreachHeapProfileObjptr (GC_state s, GC_foreachObjptrFun f) {
+  for (uint32_t i = 0; i < s->heapProfile->samplesLength; i++)
+    f (s, &s->heapProfile->samples[i].object);
+}
+
+/* Like updateWeaksForCheneyCopy, but a dead object's sample is
+ * dropped.  A minor GC leaves the old generation alone.
+ */
+void updateHeapProfileForCheneyCopy (GC_state s) {
+  struct GC_heapProfile *h;
+  uint32_t j;
+
+  h = s->heapProfile;
+  j = 0;
+  for (uint32_t i = 0; i < h->samplesLength; i++) {
+    struct GC_heapProfileSample sample;
+    pointer p;
+
+    sample = h->samples[i];
+    p = objptrToPointer (sample.object, s->heap->start);
+    if (not s->forwardState.amInMinorGC or isPointerInNursery (s, p)) {
+      if (GC_FORWARDED != getHeader (p))
+        continue;
+      sample.object = *(objptr*)p;
+    }
+    h->samples[j++] = sample;
+  }
+  h->samplesLength = j;
+}
+
+/* Called after marking; the objects still sampled are then threaded
+ * like globals.
+ */
+void updateHeapProfileForMarkCompact (GC_state s) {
+  struct GC_heapProfile *h;
+  uint32_t j;
+
+  h = s->heapProfile;
+  j = 0;
+  for (uint32_t i = 0; i < h->samplesLength; i++)
+    if (isPointerMarked (objptrToPointer (h->samples[i].object, s->heap->start)))
+      h->samples[j++] = h->samples[i];
+  h->samplesLength = j;
+}
+
+static int compareHeapProfileSites (const void *v1, const void *v2) {
+  const struct GC_heapProfileSite *s1 = *(struct GC_heapProfileSite * const *)v1;
+  const struct GC_heapProfileSite *s2 = *(struct GC_heapProfileSite * const *)v2;
+
+  if (s1->bytesLive != s2->bytesLive)
+    return (s1->bytesLive > s2->bytesLive) ? -1 : 1;
+  if (s1->bytesSampled != s2->bytesSampled)
+    return (s1->bytesSampled > s2->bytesSampled) ? -1 : 1;
+  return 0;
+}
+
+static void writeHeapProfileFrameNames (GC_state s, FILE *out,
+                                        struct GC_heapProfileSite **sites,
+                                        uint32_t sitesLength) {
+  bool *isNamed;
+
+  isNamed = (bool *) calloc_safe (s->frameLayoutsLength, sizeof (bool));
+  for (uint32_t i = 0; i < sitesLength; i++)
+    for (uint32_t j = 0; j < sites[i]->numFrames; j++) {
+      GC_frameIndex frame;
+      uint32_t *sourceSeq;
+
+      frame = sites[i]->frames[j];
+      if (isNamed[frame] or frame >= s->sourceMaps.frameSourcesLength)
+        continue;
+      isNamed[frame] = TRUE;
+      sourceSeq = s->sourceMaps.sourceSeqs[s->sourceMaps.frameSources[frame]];
+      if (0 == sourceSeq[0])
+        continue;
+      fprintf (out, "# 0x%"PRIx32" %s\n", frame,
+               getSourceName (s, sourceSeq[sourceSeq[0]]));
+    }
+  free (isNamed);
+}
+
+/* writeHeapProfile (s, when)
+ *
+ * appends, for each call stack sampled so far, the number of samples
+ * and the bytes they stand for whose objects are still live, and the
+ * same for all that were taken.  Frames are given by frame index, and,
+ * if the program was compiled with profiling, named in comments.
+ */
+void writeHeapProfile (GC_state s, const char *when) {
+  struct GC_heapProfile *h;
+  struct GC_heapProfileSite **sites;
+  uintmax_t numLive, bytesLive, numSampled, bytesSampled;
+  FILE *out;
+
+  h = s->heapProfile;
+  if (0 == h->sitesLength)
+    return;
+  if (NULL == h->out)
+    h->out = fopen_safe (s->controls->allocProfile, "w");
+  out = h->out;
+  for (uint32_t i = 0; i < h->sitesLength; i++) {
+    h->sites[i].numLive = 0;
+    h->sites[i].bytesLive = 0;
+  }
+  for (uint32_t i = 0; i < h->samplesLength; i++) {
+    h->sites[h->samples[i].site].numLive++;
+    h->sites[h->samples[i].site].bytesLive += h->samples[i].bytes;
+  }
+  sites = (struct GC_heapProfileSite **)
+    malloc_safe (h->sitesLength * sizeof (struct GC_heapProfileSite *));
+  numLive = bytesLive = numSampled = bytesSampled = 0;
+  for (uint32_t i = 0; i < h->sitesLength; i++) {
+    sites[i] = &h->sites[i];
+    numLive += h->sites[i].numLive;
+    bytesLive += h->sites[i].bytesLive;
+    numSampled += h->sites[i].numSampled;
+    bytesSampled += h->sites[i].bytesSampled;
+  }
+  qsort (sites, h->sitesLength, sizeof (struct GC_heapProfileSite *),
+         compareHeapProfileSites);
+  fprintf (out, "heap profile: %"PRIuMAX": %"PRIuMAX" [%"PRIuMAX": %"PRIuMAX"]"
+           " @ heap_v2/%"PRIuMAX"\n",
+           numLive, bytesLive, numSampled, bytesSampled,
+           (uintmax_t)s->controls->allocSampleBytes);
+  fprintf (out, "# %s, gc %"PRIuMAX", %"PRIuMAX" bytes live\n",
+           when, s->cumulativeStatistics->numGCs,
+           (uintmax_t)s->lastMajorStatistics->bytesLive);
+  for (uint32_t i = 0; i < h->sitesLength; i++) {
+    fprintf (out, "%"PRIuMAX": %"PRIuMAX" [%"PRIuMAX": %"PRIuMAX"] @",
+             sites[i]->numLive, sites[i]->bytesLive,
+             sites[i]->numSampled, sites[i]->bytesSampled);
+    for (uint32_t j = 0; j < sites[i]->numFrames; j++)
+      fprintf (out, " 0x%"PRIx32, sites[i]->frames[j]);
+    fprintf (out, "\n");
+  }
+  writeHeapProfileFrameNames (s, out, sites, h->sitesLength);
+  fprintf (out, "\n");
+  fflush (out);
+  free (sites);
+  h->numWritten++;
+}
+
+void GC_setControlsAllocSampleBytes (__attribute__ ((unused)) GC_state *gs,
+                                     size_t bytes) {
+  GC_state s = Proc_getCurrentState ();
+  s->controls->allocSampleBytes = bytes;
+}
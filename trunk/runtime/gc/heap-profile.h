@@ -0,0 +1,98 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* Allocation sampling.
+ *
+ * When the alloc-sample control is nonzero, each processor counts the
+ * bytes it allocates in the nursery, and whenever it has allocated
+ * that many since its last sample, it records the frames on its stack
+ * and the object it allocates next.  A processor only looks when it
+ * refills its allocation chunk, so the interval is rounded up to a
+ * chunk.  Samples sit in the processor's buffer until the next GC
+ * gathers them into the heap profile, which holds each sampled object
+ * like a weak pointer.  After every major GC, the profile is appended
+ * to a file, in the style of pprof's heap profiles, telling for each
+ * call stack how many of the bytes it allocated are still live.
+ */
+
+/* Frames kept, from the top of the stack. */
+#define GC_HEAP_PROFILE_MAX_FRAMES 64
+
+struct GC_heapProfileBufferSample {
+  objptr object; /* BOGUS_OBJPTR if it wasn't seen */
+  size_t bytes; /* allocated since the sample before */
+  uint32_t firstFrame; /* index into frames */
+  uint32_t numFrames;
+};
+
+/* Each processor's samples since the last GC. */
+struct GC_heapProfileBuffer {
+  size_t bytesSinceSample;
+  pointer lastFrontier; /* frontier when the mutator last got a chunk */
+  /* Where the last sample's object will be allocated, or NULL. */
+  pointer pending;
+  struct GC_heapProfileBufferSample *samples;
+  uint32_t samplesLength;
+  uint32_t samplesSize;
+  GC_frameIndex *frames;
+  uint32_t framesLength;
+  uint32_t framesSize;
+};
+
+struct GC_heapProfileSite {
+  uint32_t hash;
+  uint32_t numFrames;
+  GC_frameIndex *frames;
+  uintmax_t numSampled;
+  uintmax_t bytesSampled;
+  /* Filled in while writing a profile. */
+  uintmax_t numLive;
+  uintmax_t bytesLive;
+};
+
+struct GC_heapProfileSample {
+  objptr object;
+  size_t bytes;
+  uint32_t site;
+};
+
+struct GC_heapProfile {
+  struct GC_heapProfileSite *sites;
+  uint32_t sitesLength;
+  uint32_t sitesSize;
+  /* Sampled objects that were live at the last GC. */
+  struct GC_heapProfileSample *samples;
+  uint32_t samplesLength;
+  uint32_t samplesSize;
+  FILE *out; /* opened with the first profile written */
+  uintmax_t numWritten;
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initHeapProfile (GC_state s);
+static void initHeapProfileBuffer (GC_state s);
+static void noteAllocationForHeapProfile (GC_state s);
+static void maybeSampleAllocationForHeapProfile (GC_state s);
+static void mergeHeapProfileBuffers (GC_state s);
+static void foreachHeapProfileObjptr (GC_state s, GC_foreachObjptrFun f);
+static void updateHeapProfileForCheneyCopy (GC_state s);
+static void updateHeapProfileForMarkCompact (GC_state s);
+static void writeHeapProfile (GC_state s, const char *when);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
+
+#if (defined (MLTON_GC_INTERNAL_BASIS))
+
+PRIVATE void GC_setControlsAllocSampleBytes (GC_state *gs, size_t bytes);
+
+#endif /* (defined (MLTON_GC_INTERNAL_BASIS)) */
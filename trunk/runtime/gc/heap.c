@@ -262,6 +262,57 @@ bool createHeap (GC_state s, GC_heap h,
   return FALSE;
 }
 
+/* createHeapAt (s, h, start, desiredSize, minSize)
+ *
+ * is like createHeap, but only succeeds if the heap can be put at
+ * start.  It is used to load a world where it was saved, so that it
+ * needn't be translated.
+ */
+bool createHeapAt (GC_state s, GC_heap h, pointer start,
+                   size_t desiredSize, size_t minSize) {
+  size_t newSize;
+  size_t newWithMapsSize;
+  pointer newStart;
+
+  if (DEBUG_MEM)
+    fprintf (stderr, "createHeapAt  start = "FMTPTR"  desired size = %s  min size = %s\n",
+             (uintptr_t)start,
+             uintmaxToCommaString(desiredSize),
+             uintmaxToCommaString(minSize));
+  assert (isHeapInit (h));
+  if (desiredSize < minSize)
+    desiredSize = minSize;
+  minSize = align (minSize, s->sysvals.pageSize);
+  desiredSize = align (desiredSize, s->sysvals.pageSize);
+  assert (0 == h->size and NULL == h->start);
+  unless (isAligned ((size_t)start, s->sysvals.pageSize))
+    return FALSE;
+  newSize = desiredSize;
+  while (TRUE) {
+    newWithMapsSize = newSize + sizeofCardMapAndCrossMap (s, newSize);
+    newStart = GC_mmapAnon (start, newWithMapsSize);
+    if (start == newStart) {
+      h->start = newStart;
+      h->size = newSize;
+      h->withMapsSize = newWithMapsSize;
+      if (h->size > s->cumulativeStatistics->maxHeapSize)
+        s->cumulativeStatistics->maxHeapSize = h->size;
+      if (DEBUG or s->controls->messages)
+        fprintf (stderr,
+                 "[GC: Created heap at "FMTPTR" of size %s bytes (+ %s bytes card/cross map).]\n",
+                 (uintptr_t)(h->start),
+                 uintmaxToCommaString(h->size),
+                 uintmaxToCommaString(h->withMapsSize - h->size));
+      return TRUE;
+    }
+    unless ((void*)-1 == newStart)
+      GC_release (newStart, newWithMapsSize);
+    if (newSize == minSize)
+      return FALSE;
+    newSize = minSize;
+  }
+}
+
 /* createHeapSecondary (s, desiredSize)
  */
 bool createHeapSecondary (GC_state s, size_t desiredSize) {
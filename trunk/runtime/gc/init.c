@@ -76,6 +76,12 @@ bad:
   die ("Invalid @MLton memory amount: %s.", s);
 }
 
+/* The node of the cpu that run() in c-main.h pins processor proc to. */
+static int32_t numaNodeOfProcessor (GC_state s, int32_t proc) {
+  return GC_numaNodeOfCPU (proc * s->controls->affinityStride
+                           + s->controls->affinityBase);
+}
+
 /* ---------------------------------------------------------------- */
 /*                             GC_init                              */
 /* ---------------------------------------------------------------- */
@@ -125,6 +131,16 @@ int processAtMLton (GC_state s, int argc, char **argv,
         } else if (0 == strcmp (arg, "gc-summary")) {
           i++;
           s->controls->summary = TRUE;
+        } else if (0 == strcmp (arg, "alloc-profile")) {
+          i++;
+          if (i == argc)
+            die ("@MLton alloc-profile missing argument.");
+          s->controls->allocProfile = argv[i++];
+        } else if (0 == strcmp (arg, "alloc-sample")) {
+          i++;
+          if (i == argc)
+            die ("@MLton alloc-sample missing argument.");
+          s->controls->allocSampleBytes = stringToBytes (argv[i++]);
         } else if (0 == strcmp (arg, "alloc-chunk")) {
           i++;
           if (i == argc)
@@ -217,6 +233,46 @@ int processAtMLton (GC_state s, int argc, char **argv,
           s->controls->ratios.nursery = stringToFloat (argv[i++]);
           unless (1.0 < s->controls->ratios.nursery)
             die ("@MLton nursery-ratio argument must be greater than 1.0.");
+        } else if (0 == strcmp (arg, "private-nursery-ratio")) {
+          /* Only allocation is private; minor GCs stay global. */
+          i++;
+          if (i == argc)
+            die ("@MLton private-nursery-ratio missing argument.");
+          s->controls->ratios.privateNursery = stringToFloat (argv[i++]);
+          unless (0.0 <= s->controls->ratios.privateNursery
+                  and s->controls->ratios.privateNursery <= 1.0)
+            die ("@MLton private-nursery-ratio argument must be between 0.0 and 1.0.");
+        } else if (0 == strcmp (arg, "parallel-gc")) {
+          i++;
+          if (i == argc)
+            die ("@MLton parallel-gc missing argument.");
+          s->controls->parallelGC = stringToBool (argv[i++]);
+        } else if (0 == strcmp (arg, "concurrent-mark")) {
+          i++;
+          if (i == argc)
+            die ("@MLton concurrent-mark missing argument.");
+          s->controls->concurrentMark = stringToBool (argv[i++]);
+        } else if (0 == strcmp (arg, "compress-world")) {
+          i++;
+          if (i == argc)
+            die ("@MLton compress-world missing argument.");
+          s->controls->compressWorld = stringToBool (argv[i++]);
+        } else if (0 == strcmp (arg, "gc-trace")) {
+          i++;
+          if (i == argc)
+            die ("@MLton gc-trace missing argument.");
+          s->controls->gcTrace = argv[i++];
+        } else if (0 == strcmp (arg, "numa")) {
+          i++;
+          if (i == argc)
+            die ("@MLton numa missing argument.");
+          s->controls->numa = stringToBool (argv[i++]);
+        } else if (0 == strcmp (arg, "pinned-size")) {
+          i++;
+          if (i == argc)
+            die ("@MLton pinned-size missing argument.");
+          s->controls->pinnedSize = align (stringToBytes (argv[i++]),
+                                           s->sysvals.pageSize);
         } else if (0 == strcmp (arg, "ram-slop")) {
           i++;
           if (i == argc)
@@ -318,21 +374,30 @@ int GC_init (GC_state s, int argc, char **argv) {
   assert (sizeofThread (s) == sizeofThread (s));
   assert (sizeofWeak (s) == sizeofWeak (s));
 
+  s->amHelpingGC = FALSE;
   s->amInGC = TRUE;
   s->amOriginal = TRUE;
   s->atomicState = 0;
   s->callFromCHandlerThread = BOGUS_OBJPTR;
   s->controls = (struct GC_controls *) malloc (sizeof (struct GC_controls));
   s->controls->fixedHeap = 0;
+  s->controls->gcTrace = NULL;
+  s->controls->allocSampleBytes = 0;
+  s->controls->allocProfile = "mlalloc.out";
   s->controls->maxHeap = 0;
   s->controls->mayLoadWorld = TRUE;
   s->controls->mayPageHeap = FALSE;
+  s->controls->compressWorld = FALSE;
   s->controls->mayProcessAtMLton = TRUE;
   s->controls->messages = FALSE;
+  s->controls->parallelGC = FALSE;
   s->controls->oldGenArraySize = 0x100000;
   s->controls->allocChunkSize = 4096;
   s->controls->affinityBase = 0;
   s->controls->affinityStride = 1;
+  s->controls->numa = FALSE;
+  s->controls->concurrentMark = FALSE;
+  s->controls->pinnedSize = 0x4000000; /* 64M */
   s->controls->restrictAvailableSize = FALSE;
   s->controls->ratios.copy = 4.0;
   s->controls->ratios.copyGenerational = 4.0;
@@ -342,6 +407,7 @@ int GC_init (GC_state s, int argc, char **argv) {
   s->controls->ratios.markCompact = 1.04;
   s->controls->ratios.markCompactGenerational = 8.0;
   s->controls->ratios.nursery = 10.0;
+  s->controls->ratios.privateNursery = 0.0;
   s->controls->ratios.ramSlop = 0.5;
   s->controls->ratios.available = 1.1;
   s->controls->ratios.stackCurrentGrow = 2.0;
@@ -377,6 +443,8 @@ int GC_init (GC_state s, int argc, char **argv) {
   s->cumulativeStatistics->numHashConsGCs = 0;
   s->cumulativeStatistics->numMarkCompactGCs = 0;
   s->cumulativeStatistics->numMinorGCs = 0;
+  s->cumulativeStatistics->numParallelGCs = 0;
+  s->cumulativeStatistics->numConcurrentMarks = 0;
   timevalZero (&s->cumulativeStatistics->ru_gc);
   rusageZero (&s->cumulativeStatistics->ru_gcCopying);
   rusageZero (&s->cumulativeStatistics->ru_gcMarkCompact);
@@ -399,7 +467,11 @@ int GC_init (GC_state s, int argc, char **argv) {
   s->enableTimer = FALSE;
   s->timeInterval = 200;
   s->copiedSize = -1;
+  s->procNumber = 0;
+  s->numaNode = -1;
   s->procStates = NULL;
+  initProcessorStatistics (s);
+  initHeapProfileBuffer (s);
   s->roots = NULL;
   s->rootsLength = 0;
   s->savedThread = BOGUS_OBJPTR;
@@ -419,6 +491,9 @@ int GC_init (GC_state s, int argc, char **argv) {
   s->weaks = NULL;
   s->saveWorldStatus = true;
   s->profiling.isProfilingTimeOn = false;
+  s->profiling.data = NULL;
+  s->profiling.hasThreadTimer = FALSE;
+  s->profiling.samples.ring = NULL;
 
   initIntInf (s);
   initSignalStack (s);
@@ -436,6 +511,14 @@ int GC_init (GC_state s, int argc, char **argv) {
   unless (s->controls->ratios.stackCurrentPermitReserved
           <= s->controls->ratios.stackCurrentMaxReserved)
     die ("Ratios must satisfy stack-current-permit-reserved <= stack-current-max-reserved.");
+  if (s->controls->numa) {
+    s->numaNode = numaNodeOfProcessor (s, 0);
+    /* Only private nurseries are bound to a node. */
+    unless (s->controls->ratios.privateNursery > 0.0)
+      s->controls->ratios.privateNursery = GC_NUMA_PRIVATE_NURSERY_RATIO;
+  }
+  initEventLog (s);
+  initHeapProfile (s);
   /* We align s->ram by pageSize so that we can test whether or not we
    * we are using mark-compact by comparing heap size to ram size.  If
    * we didn't round, the size might be slightly off.
@@ -492,6 +575,7 @@ void GC_lateInit (GC_state s) {
 
 void GC_duplicate (GC_state d, GC_state s) {
   // GC_init
+  d->amHelpingGC = FALSE;
   d->amInGC = s->amInGC;
   d->amOriginal = s->amOriginal;
   d->atomicState = 0;
@@ -499,10 +583,18 @@ void GC_duplicate (GC_state d, GC_state s) {
   d->controls = s->controls;
   d->cumulativeStatistics = s->cumulativeStatistics;
   d->currentThread = BOGUS_OBJPTR;
+  d->eventLog = s->eventLog;
+  d->heapProfile = s->heapProfile;
+  initHeapProfileBuffer (d);
   d->hashConsDuringGC = s->hashConsDuringGC;
   d->lastMajorStatistics = s->lastMajorStatistics;
   d->numberOfProcs = s->numberOfProcs;
   d->numIOThreads = s->numIOThreads;
+  d->procNumber = (int32_t)(d - s->procStates);
+  initProcessorStatistics (d);
+  d->numaNode = s->controls->numa
+    ? numaNodeOfProcessor (s, d->procNumber)
+    : -1;
   d->enableTimer = s->enableTimer;
   d->timeInterval = s->timeInterval;
   d->roots = NULL;
@@ -528,7 +620,7 @@ void GC_duplicate (GC_state d, GC_state s) {
 
   d->sysvals.ram = s->sysvals.ram;
 
-  //initProfiling (d);
+  duplicateProfiling (d, s);
 
   // Multi-processor support is incompatible with saved-worlds
   assert (d->amOriginal);
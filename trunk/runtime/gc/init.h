@@ -10,6 +10,7 @@
 
 static int processAtMLton (GC_state s, int argc,
                            char **argv, char **worldFile);
+static int32_t numaNodeOfProcessor (GC_state s, int32_t proc);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
 
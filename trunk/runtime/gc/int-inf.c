@@ -175,14 +175,223 @@ objptr finiIntInfRes (GC_state s, __mpz_struct *res, size_t bytes) {
   return pointerToObjptr ((pointer)&bp->obj, s->heap->start);
 }
 
+/*
+ * Given an intInf of at most INTINF_MAGNITUDE_LIMBS limbs, fill in its
+ * sign and magnitude.  Return FALSE if it is bigger.
+ */
+bool fillSmallIntInfArg (GC_state s, objptr arg, struct GC_smallIntInf *res) {
+  GC_intInf bp;
+  GC_arrayLength numLimbs;
+
+  if (isSmall (arg)) {
+    const objptr highBitMask = (objptr)1 << (CHAR_BIT * OBJPTR_SIZE - 1);
+    res->isneg = (arg & highBitMask) != (objptr)0;
+    if (res->isneg)
+      res->mag = (objptr)(-((arg >> 1) | highBitMask));
+    else
+      res->mag = arg >> 1;
+    return TRUE;
+  }
+  bp = toBignum (s, arg);
+  numLimbs = bp->length - 1;
+  if (numLimbs > INTINF_MAGNITUDE_LIMBS)
+    return FALSE;
+  res->isneg = bp->obj.body.isneg;
+  res->mag = 0;
+  for (GC_arrayLength i = 0; i < numLimbs; i++)
+    res->mag |= (GC_intInfMagnitude)bp->obj.body.limbs[i]
+                << (i * CHAR_BIT * sizeof(mp_limb_t));
+  return TRUE;
+}
+
+/*
+ * Return the intInf with the given sign and magnitude, as a fixnum if
+ * it fits, and otherwise as a bignum at the frontier, in the space
+ * reserved for the answer.
+ */
+objptr finiSmallIntInfRes (GC_state s, struct GC_smallIntInf *res, size_t bytes) {
+  const GC_intInfMagnitude maxSmall =
+    (GC_intInfMagnitude)1 << (CHAR_BIT * OBJPTR_SIZE - 2);
+  GC_intInf bp;
+  unsigned int size;
+
+  if (DEBUG_INT_INF)
+    fprintf (stderr, "finiSmallIntInfRes ("FMTPTR", %"PRIuMAX")\n",
+             (uintptr_t)res, (uintmax_t)bytes);
+  if (res->mag == 0)
+    return (objptr)1;
+  /* The same ranges as in finiIntInfRes. */
+  if (res->isneg ? res->mag <= maxSmall : res->mag < maxSmall) {
+    objptr ans = (objptr)res->mag;
+    if (res->isneg)
+      ans = -ans;
+    return (objptr)(ans<<1 | 1);
+  }
+  assert (bytes <= (size_t)(s->limitPlusSlop - s->frontier));
+  bp = (GC_intInf)s->frontier;
+  for (size = 0; size < INTINF_MAGNITUDE_LIMBS; size++)
+    bp->obj.body.limbs[size] =
+      (mp_limb_t)(res->mag >> (size * CHAR_BIT * sizeof(mp_limb_t)));
+  while (bp->obj.body.limbs[size - 1] == 0)
+    size--;
+  bp->obj.body.isneg = res->isneg;
+  /* Offsets, not addresses of members, since GC_intInf is packed. */
+  setFrontier (s,
+               (pointer)bp + offsetof (struct GC_intInf, obj.body.limbs)
+               + size * sizeof (mp_limb_t),
+               bytes);
+  bp->counter = (GC_arrayCounter)0;
+  bp->length = (GC_arrayLength)(size + 1); /* +1 for isneg field */
+  bp->header = GC_INTINF_HEADER;
+  return pointerToObjptr ((pointer)bp + offsetof (struct GC_intInf, obj),
+                          s->heap->start);
+}
+
+/*
+ * Arithmetic on signs and magnitudes.  Each returns FALSE if the
+ * answer doesn't fit in a magnitude, or it can't tell, in which case
+ * GnuMP does it.
+ */
+static inline bool smallAdd (struct GC_smallIntInf *res,
+                             const struct GC_smallIntInf *lhs,
+                             const struct GC_smallIntInf *rhs) {
+  if (lhs->isneg == rhs->isneg) {
+    res->isneg = lhs->isneg;
+    res->mag = lhs->mag + rhs->mag;
+    return res->mag >= lhs->mag;
+  }
+  if (lhs->mag >= rhs->mag) {
+    res->isneg = lhs->isneg;
+    res->mag = lhs->mag - rhs->mag;
+  } else {
+    res->isneg = rhs->isneg;
+    res->mag = rhs->mag - lhs->mag;
+  }
+  return TRUE;
+}
+
+static inline bool smallSub (struct GC_smallIntInf *res,
+                             const struct GC_smallIntInf *lhs,
+                             const struct GC_smallIntInf *rhs) {
+  struct GC_smallIntInf negRhs;
+
+  negRhs.isneg = not rhs->isneg;
+  negRhs.mag = rhs->mag;
+  return smallAdd (res, lhs, &negRhs);
+}
+
+static inline bool smallMul (struct GC_smallIntInf *res,
+                             const struct GC_smallIntInf *lhs,
+                             const struct GC_smallIntInf *rhs) {
+  const unsigned int halfBits = CHAR_BIT * sizeof(GC_intInfMagnitude) / 2;
+
+  if ((lhs->mag >> halfBits) != 0 or (rhs->mag >> halfBits) != 0)
+    return FALSE;
+  res->isneg = lhs->isneg != rhs->isneg;
+  res->mag = lhs->mag * rhs->mag;
+  return TRUE;
+}
+
+static inline bool smallQuot (struct GC_smallIntInf *res,
+                              const struct GC_smallIntInf *lhs,
+                              const struct GC_smallIntInf *rhs) {
+  if (rhs->mag == 0)
+    return FALSE;
+  res->isneg = lhs->isneg != rhs->isneg;
+  res->mag = lhs->mag / rhs->mag;
+  return TRUE;
+}
+
+static inline bool smallRem (struct GC_smallIntInf *res,
+                             const struct GC_smallIntInf *lhs,
+                             const struct GC_smallIntInf *rhs) {
+  if (rhs->mag == 0)
+    return FALSE;
+  res->isneg = lhs->isneg;
+  res->mag = lhs->mag % rhs->mag;
+  return TRUE;
+}
+
+/* div and mod round towards negative infinity. */
+static inline bool smallDiv (struct GC_smallIntInf *res,
+                             const struct GC_smallIntInf *lhs,
+                             const struct GC_smallIntInf *rhs) {
+  if (rhs->mag == 0)
+    return FALSE;
+  res->isneg = lhs->isneg != rhs->isneg;
+  res->mag = lhs->mag / rhs->mag;
+  /* Can't overflow, since the remainder is zero if rhs->mag is 1. */
+  if (res->isneg and lhs->mag % rhs->mag != 0)
+    res->mag++;
+  return TRUE;
+}
+
+static inline bool smallMod (struct GC_smallIntInf *res,
+                             const struct GC_smallIntInf *lhs,
+                             const struct GC_smallIntInf *rhs) {
+  if (rhs->mag == 0)
+    return FALSE;
+  res->isneg = lhs->isneg;
+  res->mag = lhs->mag % rhs->mag;
+  if (res->mag != 0 and lhs->isneg != rhs->isneg) {
+    res->isneg = rhs->isneg;
+    res->mag = rhs->mag - res->mag;
+  }
+  return TRUE;
+}
+
+static inline bool smallAddMul (struct GC_smallIntInf *res,
+                                const struct GC_smallIntInf *acc,
+                                const struct GC_smallIntInf *lhs,
+                                const struct GC_smallIntInf *rhs) {
+  struct GC_smallIntInf prod;
+
+  return smallMul (&prod, lhs, rhs) and smallAdd (res, acc, &prod);
+}
+
+static inline bool smallSubMul (struct GC_smallIntInf *res,
+                                const struct GC_smallIntInf *acc,
+                                const struct GC_smallIntInf *lhs,
+                                const struct GC_smallIntInf *rhs) {
+  struct GC_smallIntInf prod;
+
+  return smallMul (&prod, lhs, rhs) and smallSub (res, acc, &prod);
+}
+
+static inline int smallCompare (const struct GC_smallIntInf *lhs,
+                                const struct GC_smallIntInf *rhs) {
+  int res;
+
+  if (lhs->isneg != rhs->isneg)
+    return lhs->isneg ? -1 : 1;
+  if (lhs->mag == rhs->mag)
+    return 0;
+  res = lhs->mag < rhs->mag ? -1 : 1;
+  return lhs->isneg ? - res : res;
+}
+
+/*
+ * The operations below first try the operation on signs and
+ * magnitudes, if there is one and the arguments are small enough, and
+ * otherwise use GnuMP.
+ */
 static inline objptr binary (objptr lhs, objptr rhs, size_t bytes,
+                             bool(*smallop)(struct GC_smallIntInf *res,
+                                            const struct GC_smallIntInf *lhs,
+                                            const struct GC_smallIntInf *rhs),
                              void(*binop)(__mpz_struct *resmpz,
                                           __gmp_const __mpz_struct *lhsspace,
                                           __gmp_const __mpz_struct *rhsspace)) {
   __mpz_struct lhsmpz, rhsmpz, resmpz;
   mp_limb_t lhsspace[LIMBS_PER_OBJPTR + 1], rhsspace[LIMBS_PER_OBJPTR + 1];
-
-  GC_state s = pthread_getspecific (gcstate_key);
+  struct GC_smallIntInf lhssmall, rhssmall, ressmall;
+
+  GC_state s = Proc_getCurrentState ();
+  if (smallop != NULL
+      and fillSmallIntInfArg (s, lhs, &lhssmall)
+      and fillSmallIntInfArg (s, rhs, &rhssmall)
+      and smallop (&ressmall, &lhssmall, &rhssmall))
+    return finiSmallIntInfRes (s, &ressmall, bytes);
   initIntInfRes (s, &resmpz, bytes);
   fillIntInfArg (s, lhs, &lhsmpz, lhsspace);
   fillIntInfArg (s, rhs, &rhsmpz, rhsspace);
@@ -194,63 +403,122 @@ objptr IntInf_add (objptr lhs, objptr rhs, size_t bytes) {
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_add ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
              lhs, rhs, (uintmax_t)bytes);
-  return binary (lhs, rhs, bytes, &mpz_add);
+  return binary (lhs, rhs, bytes, &smallAdd, &mpz_add);
 }
 
 objptr IntInf_andb (objptr lhs, objptr rhs, size_t bytes) {
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_andb ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
              lhs, rhs, (uintmax_t)bytes);
-  return binary (lhs, rhs, bytes, &mpz_and);
+  return binary (lhs, rhs, bytes, NULL, &mpz_and);
+}
+
+objptr IntInf_div (objptr lhs, objptr rhs, size_t bytes) {
+  if (DEBUG_INT_INF)
+    fprintf (stderr, "IntInf_div ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
+             lhs, rhs, (uintmax_t)bytes);
+  return binary (lhs, rhs, bytes, &smallDiv, &mpz_fdiv_q);
 }
 
 objptr IntInf_gcd (objptr lhs, objptr rhs, size_t bytes) {
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_gcd ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
              lhs, rhs, (uintmax_t)bytes);
-  return binary (lhs, rhs, bytes, &mpz_gcd);
+  return binary (lhs, rhs, bytes, NULL, &mpz_gcd);
+}
+
+objptr IntInf_mod (objptr lhs, objptr rhs, size_t bytes) {
+  if (DEBUG_INT_INF)
+    fprintf (stderr, "IntInf_mod ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
+             lhs, rhs, (uintmax_t)bytes);
+  return binary (lhs, rhs, bytes, &smallMod, &mpz_fdiv_r);
 }
 
 objptr IntInf_mul (objptr lhs, objptr rhs, size_t bytes) {
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_mul ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
              lhs, rhs, (uintmax_t)bytes);
-  return binary (lhs, rhs, bytes, &mpz_mul);
+  return binary (lhs, rhs, bytes, &smallMul, &mpz_mul);
 }
 
 objptr IntInf_quot (objptr lhs, objptr rhs, size_t bytes) {
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_quot ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
              lhs, rhs, (uintmax_t)bytes);
-  return binary (lhs, rhs, bytes, &mpz_tdiv_q);
+  return binary (lhs, rhs, bytes, &smallQuot, &mpz_tdiv_q);
 }
 
 objptr IntInf_orb (objptr lhs, objptr rhs, size_t bytes) {
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_orb ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
              lhs, rhs, (uintmax_t)bytes);
-  return binary (lhs, rhs, bytes, &mpz_ior);
+  return binary (lhs, rhs, bytes, NULL, &mpz_ior);
 }
 
 objptr IntInf_rem (objptr lhs, objptr rhs, size_t bytes) {
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_quot ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
              lhs, rhs, (uintmax_t)bytes);
-  return binary (lhs, rhs, bytes, &mpz_tdiv_r);
+  return binary (lhs, rhs, bytes, &smallRem, &mpz_tdiv_r);
 }
 
 objptr IntInf_sub (objptr lhs, objptr rhs, size_t bytes) {
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_sub ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
              lhs, rhs, (uintmax_t)bytes);
-  return binary (lhs, rhs, bytes, &mpz_sub);
+  return binary (lhs, rhs, bytes, &smallSub, &mpz_sub);
 }
 
 objptr IntInf_xorb (objptr lhs, objptr rhs, size_t bytes) {
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_xorb ("FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
              lhs, rhs, (uintmax_t)bytes);
-  return binary (lhs, rhs, bytes, &mpz_xor);
+  return binary (lhs, rhs, bytes, NULL, &mpz_xor);
+}
+
+/*
+ * acc + lhs * rhs and acc - lhs * rhs, with one result.
+ */
+static inline objptr ternary (objptr acc, objptr lhs, objptr rhs, size_t bytes,
+                              bool(*smallop)(struct GC_smallIntInf *res,
+                                             const struct GC_smallIntInf *acc,
+                                             const struct GC_smallIntInf *lhs,
+                                             const struct GC_smallIntInf *rhs),
+                              void(*ternop)(__mpz_struct *resmpz,
+                                            __gmp_const __mpz_struct *lhsspace,
+                                            __gmp_const __mpz_struct *rhsspace)) {
+  __mpz_struct accmpz, lhsmpz, rhsmpz, resmpz;
+  mp_limb_t accspace[LIMBS_PER_OBJPTR + 1], lhsspace[LIMBS_PER_OBJPTR + 1],
+    rhsspace[LIMBS_PER_OBJPTR + 1];
+  struct GC_smallIntInf accsmall, lhssmall, rhssmall, ressmall;
+
+  GC_state s = Proc_getCurrentState ();
+  if (fillSmallIntInfArg (s, acc, &accsmall)
+      and fillSmallIntInfArg (s, lhs, &lhssmall)
+      and fillSmallIntInfArg (s, rhs, &rhssmall)
+      and smallop (&ressmall, &accsmall, &lhssmall, &rhssmall))
+    return finiSmallIntInfRes (s, &ressmall, bytes);
+  initIntInfRes (s, &resmpz, bytes);
+  fillIntInfArg (s, acc, &accmpz, accspace);
+  fillIntInfArg (s, lhs, &lhsmpz, lhsspace);
+  fillIntInfArg (s, rhs, &rhsmpz, rhsspace);
+  mpz_set (&resmpz, &accmpz);
+  ternop (&resmpz, &lhsmpz, &rhsmpz);
+  return finiIntInfRes (s, &resmpz, bytes);
+}
+
+objptr IntInf_addMul (objptr acc, objptr lhs, objptr rhs, size_t bytes) {
+  if (DEBUG_INT_INF)
+    fprintf (stderr, "IntInf_addMul ("FMTOBJPTR", "FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
+             acc, lhs, rhs, (uintmax_t)bytes);
+  return ternary (acc, lhs, rhs, bytes, &smallAddMul, &mpz_addmul);
+}
+
+objptr IntInf_subMul (objptr acc, objptr lhs, objptr rhs, size_t bytes) {
+  if (DEBUG_INT_INF)
+    fprintf (stderr, "IntInf_subMul ("FMTOBJPTR", "FMTOBJPTR", "FMTOBJPTR", %"PRIuMAX")\n",
+             acc, lhs, rhs, (uintmax_t)bytes);
+  return ternary (acc, lhs, rhs, bytes, &smallSubMul, &mpz_submul);
 }
 
 static objptr unary (objptr arg, size_t bytes,
@@ -267,9 +535,16 @@ static objptr unary (objptr arg, size_t bytes,
 }
 
 objptr IntInf_neg (objptr arg, size_t bytes) {
+  struct GC_smallIntInf argsmall;
+  GC_state s = pthread_getspecific (gcstate_key);
+
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_neg ("FMTOBJPTR", %"PRIuMAX")\n",
              arg, (uintmax_t)bytes);
+  if (fillSmallIntInfArg (s, arg, &argsmall)) {
+    argsmall.isneg = not argsmall.isneg;
+    return finiSmallIntInfRes (s, &argsmall, bytes);
+  }
   return unary (arg, bytes, &mpz_neg);
 }
 
@@ -316,12 +591,16 @@ objptr IntInf_lshift (objptr arg, Word32_t shift, size_t bytes) {
 Int32_t IntInf_compare (objptr lhs, objptr rhs) {
   __mpz_struct lhsmpz, rhsmpz;
   mp_limb_t lhsspace[LIMBS_PER_OBJPTR + 1], rhsspace[LIMBS_PER_OBJPTR + 1];
+  struct GC_smallIntInf lhssmall, rhssmall;
   int res;
   GC_state s = pthread_getspecific (gcstate_key);
 
   if (DEBUG_INT_INF)
     fprintf (stderr, "IntInf_compare ("FMTOBJPTR", "FMTOBJPTR")\n",
              lhs, rhs);
+  if (fillSmallIntInfArg (s, lhs, &lhssmall)
+      and fillSmallIntInfArg (s, rhs, &rhssmall))
+    return smallCompare (&lhssmall, &rhssmall);
   fillIntInfArg (s, lhs, &lhsmpz, lhsspace);
   fillIntInfArg (s, rhs, &rhsmpz, rhsspace);
   res = mpz_cmp (&lhsmpz, &rhsmpz);
@@ -37,6 +37,27 @@ COMPILE_TIME_ASSERT(GC_intInf__obj_body_limbs_packed,
                     offsetof(struct GC_intInf, obj) 
                     + sizeof(mp_limb_t));
 
+/* Operands of at most two limbs are handled without GMP, as a sign
+ * and a magnitude in a double-width word, when the C compiler has
+ * one.  Otherwise, only operands of one limb are.
+ */
+#if (defined (GMP_LIMB_BITS)) && (GMP_LIMB_BITS == 32)
+typedef uint64_t GC_intInfMagnitude;
+#define INTINF_MAGNITUDE_LIMBS 2
+#elif (defined (GMP_LIMB_BITS)) && (GMP_LIMB_BITS == 64) \
+      && (defined (__SIZEOF_INT128__))
+__extension__ typedef unsigned __int128 GC_intInfMagnitude;
+#define INTINF_MAGNITUDE_LIMBS 2
+#else
+typedef mp_limb_t GC_intInfMagnitude;
+#define INTINF_MAGNITUDE_LIMBS 1
+#endif
+
+struct GC_smallIntInf {
+  bool isneg;
+  GC_intInfMagnitude mag;
+};
+
 #endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
 
 #if (defined (MLTON_GC_INTERNAL_FUNCS))
@@ -61,6 +82,10 @@ static inline void fillIntInfArg (GC_state s, objptr arg, __mpz_struct *res,
                                   mp_limb_t space[LIMBS_PER_OBJPTR + 1]);
 static inline void initIntInfRes (GC_state s, __mpz_struct *res, size_t bytes);
 static inline objptr finiIntInfRes (GC_state s, __mpz_struct *res, size_t bytes);
+static inline bool fillSmallIntInfArg (GC_state s, objptr arg,
+                                       struct GC_smallIntInf *res);
+static inline objptr finiSmallIntInfRes (GC_state s, struct GC_smallIntInf *res,
+                                         size_t bytes);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
 
@@ -68,13 +93,17 @@ static inline objptr finiIntInfRes (GC_state s, __mpz_struct *res, size_t bytes)
 
 PRIVATE objptr IntInf_add (objptr lhs, objptr rhs, size_t bytes);
 PRIVATE objptr IntInf_andb (objptr lhs, objptr rhs, size_t bytes);
+PRIVATE objptr IntInf_div (objptr lhs, objptr rhs, size_t bytes);
 PRIVATE objptr IntInf_gcd (objptr lhs, objptr rhs, size_t bytes);
+PRIVATE objptr IntInf_mod (objptr lhs, objptr rhs, size_t bytes);
 PRIVATE objptr IntInf_mul (objptr lhs, objptr rhs, size_t bytes);
 PRIVATE objptr IntInf_quot (objptr lhs, objptr rhs, size_t bytes);
 PRIVATE objptr IntInf_orb (objptr lhs, objptr rhs, size_t bytes);
 PRIVATE objptr IntInf_rem (objptr lhs, objptr rhs, size_t bytes);
 PRIVATE objptr IntInf_sub (objptr lhs, objptr rhs, size_t bytes);
 PRIVATE objptr IntInf_xorb (objptr lhs, objptr rhs, size_t bytes);
+PRIVATE objptr IntInf_addMul (objptr acc, objptr lhs, objptr rhs, size_t bytes);
+PRIVATE objptr IntInf_subMul (objptr acc, objptr lhs, objptr rhs, size_t bytes);
 PRIVATE objptr IntInf_neg (objptr arg, size_t bytes);
 PRIVATE objptr IntInf_notb (objptr arg, size_t bytes);
 PRIVATE objptr IntInf_arshift (objptr arg, Word32_t shift, size_t bytes);
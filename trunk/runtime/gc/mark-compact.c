@@ -365,10 +365,12 @@ void majorMarkCompactGC (GC_state s) {
   size_t bytesMarkCompacted;
   GC_stack currentStack;
   struct rusage ru_start;
+  uint64_t phaseStart;
 
   if (detailedGCTime (s))
     startTiming (&ru_start);
   s->cumulativeStatistics->numMarkCompactGCs++;
+  setGCEventKind (s, GC_EVENT_MARK_COMPACT);
   if (DEBUG or s->controls->messages) {
     fprintf (stderr,
              "[GC: Starting major mark-compact;]\n");
@@ -378,19 +380,33 @@ void majorMarkCompactGC (GC_state s) {
              uintmaxToCommaString(s->heap->size));
   }
   currentStack = getStackCurrent (s);
-  if (s->hashConsDuringGC) {
+  phaseStart = getGCEventTime ();
+  if (isConcurrentMarkRunning ()) {
+    assert (not s->hashConsDuringGC);
+    finishConcurrentMark (s);
+  } else if (s->hashConsDuringGC) {
     s->lastMajorStatistics->bytesHashConsed = 0;
     s->cumulativeStatistics->numHashConsGCs++;
-    s->objectHashTable = allocHashTable (s);
-    foreachGlobalObjptr (s, dfsMarkWithHashConsWithLinkWeaks);
-    freeHashTable (s->objectHashTable);
+    if (shouldShareInParallel (s)) {
+      beginParallelShare (s);
+      foreachGlobalObjptr (s, addParallelShareRoot);
+      shareInParallel (s, TRUE);
+    } else {
+      s->objectHashTable = allocHashTable (s);
+      foreachGlobalObjptr (s, dfsMarkWithHashConsWithLinkWeaks);
+      freeHashTable (s->objectHashTable);
+    }
   } else {
     foreachGlobalObjptr (s, dfsMarkWithoutHashConsWithLinkWeaks);
   }
+  phaseStart = addGCEventPhaseTime (s, GC_PHASE_MARK, phaseStart);
   updateWeaksForMarkCompact (s);
+  updateHeapProfileForMarkCompact (s);
   foreachGlobalObjptr (s, threadInternalObjptr);
+  foreachHeapProfileObjptr (s, threadInternalObjptr);
   updateForwardPointersForMarkCompact (s, currentStack);
   updateBackwardPointersAndSlideForMarkCompact (s, currentStack);
+  addGCEventPhaseTime (s, GC_PHASE_COMPACT, phaseStart);
   bytesHashConsed = s->lastMajorStatistics->bytesHashConsed;
   s->cumulativeStatistics->bytesHashConsed += bytesHashConsed;
   bytesMarkCompacted = s->heap->oldGenSize;
@@ -54,9 +54,8 @@ GC_stack newStack (GC_state s,
   GC_stack stack;
 
   assert (isStackReservedAligned (s, reserved));
-  /* XXX unsafe concurrent access */
-  if (reserved > s->cumulativeStatistics->maxStackSize)
-    s->cumulativeStatistics->maxStackSize = reserved;
+  if (reserved > s->procStatistics.maxStackSize)
+    s->procStatistics.maxStackSize = reserved;
   stack = (GC_stack)(newObject (s, GC_STACK_HEADER,
                                 sizeofStackWithHeader (s, reserved),
                                 allocInOldGen));
@@ -95,8 +94,7 @@ static inline void setFrontier (GC_state s, pointer p,
   p = alignFrontier (s, p);
   assert ((size_t)(p - s->frontier) <= bytes);
   GC_profileAllocInc (s, p - s->frontier);
-  /* XXX unsafe concurrent access */
-  s->cumulativeStatistics->bytesAllocated += p - s->frontier;
+  s->procStatistics.bytesAllocated += p - s->frontier;
   s->frontier = p;
   assert (s->frontier <= s->limitPlusSlop);
   assert (s->start <= s->frontier);
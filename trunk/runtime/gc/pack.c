@@ -51,6 +51,7 @@ void GC_unpack (__attribute__ ((unused)) GC_state *gs) {
    * stack.  The leaveGC has to happen after the setStack.
    */
   enterGC (s);
+  abortConcurrentMark (s);
   minorGC (s);
   resizeHeap (s, s->heap->oldGenSize);
   setCardMapAndCrossMap (s);
@@ -0,0 +1,533 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* ---------------------------------------------------------------- */
+/*                    Parallel Cheney Copying                       */
+/* ---------------------------------------------------------------- */
+
+/* State shared by all workers during a round of parallel copying.  It
+ * is only written by the collector, before the round is published by
+ * bumping round.
+ */
+static struct {
+  volatile uint32_t round;
+  GC_state collector;
+  GC_foreachObjptrFun forward;
+  bool amInMinorGC;
+  pointer toStart;
+  pointer toLimit;
+  /* Current stacks of all processors, computed before anything is
+   * forwarded.  (The roots themselves are updated concurrently.)
+   */
+  GC_stack *currentStacks;
+  int32_t numWorkers;
+  int32_t numTasks;
+  volatile pointer back; /* next unclaimed byte of to-space */
+  volatile int32_t nextTask;
+  /* Set once some worker has taken the root task of each processor. */
+  volatile int32_t *rootTaskTaken;
+  volatile int32_t idle;
+  volatile int32_t finished;
+} parallelCopy;
+
+static struct GC_parallelCopyWorker *parallelCopyWorkers = NULL;
+
+static inline void lockParallelCopyDeque (struct GC_parallelCopyDeque *d) {
+  while (__sync_lock_test_and_set (&d->lock, 1))
+    while (d->lock) { }
+}
+
+static inline void unlockParallelCopyDeque (struct GC_parallelCopyDeque *d) {
+  __sync_lock_release (&d->lock);
+}
+
+static void pushParallelCopyRange (struct GC_parallelCopyDeque *d,
+                                   pointer front, pointer back) {
+  assert (front < back);
+  lockParallelCopyDeque (d);
+  if (d->top == d->capacity) {
+    if (d->bottom > 0) {
+      memmove (d->ranges, d->ranges + d->bottom,
+               (d->top - d->bottom) * sizeof (struct GC_parallelCopyRange));
+      d->top -= d->bottom;
+      d->bottom = 0;
+    } else {
+      d->capacity = (0 == d->capacity) ? 64 : 2 * d->capacity;
+      d->ranges = (struct GC_parallelCopyRange *)
+        realloc_safe (d->ranges,
+                      d->capacity * sizeof (struct GC_parallelCopyRange));
+    }
+  }
+  d->ranges[d->top].front = front;
+  d->ranges[d->top].back = back;
+  d->top++;
+  unlockParallelCopyDeque (d);
+}
+
+static bool popParallelCopyRange (struct GC_parallelCopyDeque *d,
+                                  struct GC_parallelCopyRange *r) {
+  bool res;
+
+  lockParallelCopyDeque (d);
+  if (d->top == d->bottom) {
+    d->top = d->bottom = 0;
+    res = FALSE;
+  } else {
+    *r = d->ranges[--d->top];
+    res = TRUE;
+  }
+  unlockParallelCopyDeque (d);
+  return res;
+}
+
+static bool stealParallelCopyRange (struct GC_parallelCopyDeque *d,
+                                    struct GC_parallelCopyRange *r) {
+  bool res;
+
+  /* Don't bother taking the lock if there is obviously nothing there. */
+  if (d->top == d->bottom)
+    return FALSE;
+  lockParallelCopyDeque (d);
+  if (d->top == d->bottom) {
+    res = FALSE;
+  } else {
+    *r = d->ranges[d->bottom++];
+    res = TRUE;
+  }
+  unlockParallelCopyDeque (d);
+  return res;
+}
+
+/* Claim bytes of to-space for a LAB of at most maxBytes.  Returns the
+ * start of the claimed space and sets *bytesRet to the amount claimed,
+ * which is never less than minBytes.
+ */
+static pointer claimToSpaceInParallel (size_t minBytes, size_t maxBytes,
+                                       size_t *bytesRet) {
+  pointer oldBack;
+  size_t bytes;
+
+  assert (minBytes <= maxBytes);
+  do {
+    oldBack = parallelCopy.back;
+    bytes = (size_t)(parallelCopy.toLimit - oldBack);
+    if (bytes < minBytes)
+      die ("Out of memory.  Insufficient to-space for parallel copy.");
+    if (bytes > maxBytes)
+      bytes = maxBytes;
+  } while (not __sync_bool_compare_and_swap (&parallelCopy.back,
+                                             oldBack, oldBack + bytes));
+  *bytesRet = bytes;
+  return oldBack;
+}
+
+/* Give up the current LAB.  Any objects that were copied into it but
+ * not yet scanned are pushed for someone to scan, and the unused tail
+ * is filled so that to-space remains parsable.
+ */
+static void retireLAB (GC_state s, struct GC_parallelCopyWorker *w) {
+  if (w->scan < s->forwardState.back)
+    pushParallelCopyRange (&w->deque, w->scan, s->forwardState.back);
+  fillGap (s, s->forwardState.back, s->forwardState.toLimit);
+  w->scan = s->forwardState.back = s->forwardState.toLimit;
+}
+
+/* Reserve bytes of to-space for an object.  Small objects go into the
+ * worker's LAB; if the LAB is nearly full it is replaced.  Objects
+ * that do not fit are allocated directly from to-space, in which case
+ * *isDirectRet is set and the caller must arrange for the object to be
+ * scanned.
+ */
+static pointer allocInToSpaceInParallel (GC_state s,
+                                         struct GC_parallelCopyWorker *w,
+                                         size_t bytes, bool *isDirectRet) {
+  pointer res;
+  size_t labBytes;
+  size_t remaining;
+
+  remaining = (size_t)(s->forwardState.toLimit - s->forwardState.back);
+  if (bytes <= remaining) {
+    res = s->forwardState.back;
+    s->forwardState.back += bytes;
+    *isDirectRet = FALSE;
+    return res;
+  }
+  if (bytes >= GC_PARALLEL_LAB_SIZE / 2
+      or remaining >= GC_PARALLEL_LAB_SIZE / 16) {
+    /* Keep the LAB; wasting its remainder would cost too much. */
+    res = claimToSpaceInParallel (bytes, bytes, &labBytes);
+    *isDirectRet = TRUE;
+    return res;
+  }
+  retireLAB (s, w);
+  res = claimToSpaceInParallel (bytes, GC_PARALLEL_LAB_SIZE, &labBytes);
+  w->scan = res;
+  s->forwardState.toLimit = res + labBytes;
+  s->forwardState.back = res + bytes;
+  *isDirectRet = FALSE;
+  return res;
+}
+
+static bool isCurrentStackInParallel (GC_state s, GC_stack stack) {
+  for (int proc = 0; proc < s->numberOfProcs; proc++)
+    if (parallelCopy.currentStacks[proc] == stack
+        and not isStackEmpty (stack))
+      return TRUE;
+  return FALSE;
+}
+
+/* Like forwardObjptr, except that several processors may race to
+ * forward the same object.  The winner swaps the header for GC_BUSY,
+ * copies the object, and then publishes the forwarding pointer; the
+ * losers wait for the header to become GC_FORWARDED.
+ */
+static void forwardObjptrInParallel (GC_state s, objptr *opp) {
+  struct GC_parallelCopyWorker *w;
+  objptr op;
+  pointer p;
+  volatile GC_header *headerp;
+  GC_header header;
+
+  op = *opp;
+  p = objptrToPointer (op, s->heap->start);
+  if (DEBUG_PARALLEL_GC)
+    fprintf (stderr,
+             "forwardObjptrInParallel  opp = "FMTPTR"  op = "FMTOBJPTR"  p = "FMTPTR" [%d]\n",
+             (uintptr_t)opp, op, (uintptr_t)p, Proc_processorNumber (s));
+  assert (isObjptrInFromSpace (s, *opp));
+  headerp = (volatile GC_header *)getHeaderp (p);
+  header = *headerp;
+  while (header != GC_FORWARDED) {
+    size_t size, skip;
+    size_t headerBytes, objectBytes;
+    GC_objectTypeTag tag;
+    uint16_t bytesNonObjptrs, numObjptrs;
+    pointer copy;
+    bool isDirect;
+
+    if (header == GC_BUSY) {
+      /* Someone else is copying it. */
+      header = *headerp;
+      continue;
+    }
+    if (not __sync_bool_compare_and_swap (headerp, header, GC_BUSY)) {
+      header = *headerp;
+      continue;
+    }
+
+    splitHeader (s, header, &tag, NULL, &bytesNonObjptrs, &numObjptrs);
+    if ((NORMAL_TAG == tag) or (WEAK_TAG == tag)) {
+      headerBytes = GC_NORMAL_HEADER_SIZE;
+      objectBytes = bytesNonObjptrs + (numObjptrs * OBJPTR_SIZE);
+      skip = 0;
+    } else if (ARRAY_TAG == tag) {
+      headerBytes = GC_ARRAY_HEADER_SIZE;
+      objectBytes = sizeofArrayNoHeader (s, getArrayLength (p),
+                                         bytesNonObjptrs, numObjptrs);
+      skip = 0;
+    } else {
+      size_t reservedNew;
+      GC_stack stack;
+
+      assert (STACK_TAG == tag);
+      headerBytes = GC_STACK_HEADER_SIZE;
+      stack = (GC_stack)p;
+      reservedNew = sizeofStackShrinkReserved
+        (s, stack, isCurrentStackInParallel (s, stack));
+      if (reservedNew < stack->reserved) {
+        if (DEBUG_STACKS or s->controls->messages)
+          fprintf (stderr,
+                   "[GC: Shrinking stack of size %s bytes to size %s bytes, using %s bytes.]\n",
+                   uintmaxToCommaString(stack->reserved),
+                   uintmaxToCommaString(reservedNew),
+                   uintmaxToCommaString(stack->used));
+        stack->reserved = reservedNew;
+      }
+      objectBytes = sizeof (struct GC_stack) + stack->used;
+      skip = stack->reserved - stack->used;
+    }
+    size = headerBytes + objectBytes;
+    w = &parallelCopyWorkers[s - s->procStates];
+    copy = allocInToSpaceInParallel (s, w, size + skip, &isDirect);
+    GC_memcpy (p - headerBytes, copy, size);
+    /* The copy picked up GC_BUSY; put back the real header. */
+    *((GC_header*)(copy + headerBytes - GC_HEADER_SIZE)) = header;
+    if ((WEAK_TAG == tag) and (numObjptrs == 1)) {
+      GC_weak weak;
+
+      weak = (GC_weak)(copy + GC_NORMAL_HEADER_SIZE + offsetofWeak (s));
+      if (isObjptr (weak->objptr)
+          and (not parallelCopy.amInMinorGC
+               or isObjptrInNursery (s, weak->objptr))) {
+        weak->link = s->weaks;
+        s->weaks = weak;
+      }
+    }
+    if (isDirect)
+      pushParallelCopyRange (&w->deque, copy, copy + size + skip);
+    *((objptr*)p) = pointerToObjptr (copy + headerBytes,
+                                     s->forwardState.toStart);
+    __sync_synchronize ();
+    *headerp = GC_FORWARDED;
+    break;
+  }
+  __sync_synchronize ();
+  *opp = *((objptr*)p);
+  assert (parallelCopy.toStart <= objptrToPointer (*opp, s->heap->start)
+          and objptrToPointer (*opp, s->heap->start) < parallelCopy.toLimit);
+}
+
+static void forwardObjptrIfInNurseryInParallel (GC_state s, objptr *opp) {
+  pointer p;
+
+  p = objptrToPointer (*opp, s->heap->start);
+  if (p < s->heap->nursery)
+    return;
+  assert (p < s->heap->frontier);
+  forwardObjptrInParallel (s, opp);
+}
+
+/* Root tasks are numbered as follows: one for each processor's
+ * threads and roots, and then one for each chunk of globals.
+ */
+static void runParallelCopyRootTask (GC_state s, int32_t task) {
+  GC_foreachObjptrFun f;
+
+  f = parallelCopy.forward;
+  if (task < s->numberOfProcs) {
+    foreachProcessorObjptr (s, &s->procStates[task], f);
+  } else {
+    uint32_t i, max;
+
+    i = (uint32_t)(task - s->numberOfProcs) * GC_PARALLEL_GLOBALS_PER_TASK;
+    max = min (i + GC_PARALLEL_GLOBALS_PER_TASK, s->globalsLength);
+    for ( ; i < max; i++)
+      callIfIsObjptr (s, f, &s->globals[i]);
+  }
+}
+
+/* Each processor's roots are a single task, which must only run once:
+ * a worker may take its own processor's task ahead of its turn.
+ */
+static bool takeParallelCopyRootTask (GC_state s, int32_t task) {
+  if (task >= s->numberOfProcs)
+    return TRUE;
+  return __sync_bool_compare_and_swap (&parallelCopy.rootTaskTaken[task], 0, 1);
+}
+
+static void scanParallelCopyRange (GC_state s, struct GC_parallelCopyRange *r) {
+  if (DEBUG_PARALLEL_GC)
+    fprintf (stderr, "scanning range "FMTPTR" - "FMTPTR" [%d]\n",
+             (uintptr_t)r->front, (uintptr_t)r->back,
+             Proc_processorNumber (s));
+  foreachObjptrInRange (s, r->front, &r->back, parallelCopy.forward, TRUE);
+}
+
+/* Scan everything this worker can find without stealing. */
+static void drainParallelCopyWork (GC_state s, struct GC_parallelCopyWorker *w) {
+  struct GC_parallelCopyRange r;
+
+  while (TRUE) {
+    if (w->scan < s->forwardState.back) {
+      pointer p;
+
+      if (parallelCopy.idle > 0
+          and (size_t)(s->forwardState.back - w->scan) >= GC_PARALLEL_SPLIT_SIZE) {
+        /* Share the unscanned part of our LAB with the idle workers. */
+        pushParallelCopyRange (&w->deque, w->scan, s->forwardState.back);
+        w->scan = s->forwardState.back;
+        continue;
+      }
+      p = advanceToObjectData (s, w->scan);
+      /* Advance scan before scanning the object, since forwarding its
+       * objptrs may retire the LAB, which pushes [scan, back).
+       */
+      w->scan += sizeofObject (s, p);
+      foreachObjptrInObject (s, p, parallelCopy.forward, TRUE);
+    } else if (popParallelCopyRange (&w->deque, &r)) {
+      scanParallelCopyRange (s, &r);
+    } else
+      return;
+  }
+}
+
+/* Look for work on the other workers' deques.  Returns FALSE once all
+ * of the workers are idle, which means that the round is over.
+ */
+static bool stealParallelCopyWork (int32_t myNumber,
+                                   struct GC_parallelCopyRange *r) {
+  while (parallelCopy.idle < parallelCopy.numWorkers) {
+    for (int32_t i = 1; i < parallelCopy.numWorkers; i++) {
+      struct GC_parallelCopyDeque *d;
+
+      d = &parallelCopyWorkers[(myNumber + i) % parallelCopy.numWorkers].deque;
+      /* Peek without the lock, rereading top and bottom on each pass
+       * since the owner changes them under us.
+       */
+      if (*(volatile uint32_t *)&d->top == *(volatile uint32_t *)&d->bottom)
+        continue;
+      /* Stop being idle before taking the work, so that no one
+       * decides that the round is over while we hold it.
+       */
+      __sync_fetch_and_sub (&parallelCopy.idle, 1);
+      if (stealParallelCopyRange (d, r))
+        return TRUE;
+      __sync_fetch_and_add (&parallelCopy.idle, 1);
+    }
+  }
+  return FALSE;
+}
+
+static void runParallelCopyWorker (GC_state s) {
+  struct GC_parallelCopyWorker *w;
+  struct GC_parallelCopyRange r;
+  int32_t myNumber, task;
+
+  myNumber = Proc_processorNumber (s);
+  w = &parallelCopyWorkers[myNumber];
+  if (DEBUG_PARALLEL_GC)
+    fprintf (stderr, "[GC: Joining parallel copy round %"PRIu32".] [%d]\n",
+             parallelCopy.round, myNumber);
+  s->forwardState.amInMinorGC = parallelCopy.amInMinorGC;
+  s->forwardState.toStart = parallelCopy.toStart;
+  s->forwardState.back = s->forwardState.toLimit = parallelCopy.toStart;
+  w->scan = parallelCopy.toStart;
+  /* Only the collector's list of weaks is meaningful. */
+  if (s != parallelCopy.collector)
+    s->weaks = NULL;
+
+  /* The collector owns the card map, so it scans the old generation. */
+  if (s == parallelCopy.collector and parallelCopy.amInMinorGC)
+    forwardInterGenerationalObjptrs (s, forwardObjptrIfInNurseryInParallel);
+  /* Start with our own processor's roots, so that what it uses is
+   * copied into our LABs and, with the numa control, onto our node.
+   */
+  if (takeParallelCopyRootTask (s, myNumber))
+    runParallelCopyRootTask (s, myNumber);
+  while ((task = __sync_fetch_and_add (&parallelCopy.nextTask, 1))
+         < parallelCopy.numTasks)
+    if (takeParallelCopyRootTask (s, task))
+      runParallelCopyRootTask (s, task);
+  while (TRUE) {
+    drainParallelCopyWork (s, w);
+    __sync_fetch_and_add (&parallelCopy.idle, 1);
+    unless (stealParallelCopyWork (myNumber, &r))
+      break;
+    scanParallelCopyRange (s, &r);
+  }
+  fillGap (s, s->forwardState.back, s->forwardState.toLimit);
+  s->forwardState.back = s->forwardState.toLimit;
+  __sync_fetch_and_add (&parallelCopy.finished, 1);
+}
+
+/* Called by processors waiting for the runtime; joins the current
+ * round of parallel copying if there is one that we haven't helped
+ * with yet.
+ */
+void maybeHelpParallelCopy (GC_state s) {
+  struct GC_parallelCopyWorker *w;
+  uint32_t round;
+
+  round = parallelCopy.round;
+  if (0 == round)
+    return;
+  w = &parallelCopyWorkers[Proc_processorNumber (s)];
+  if (w->lastRound == round)
+    return;
+  w->lastRound = round;
+  __sync_synchronize ();
+  s->amHelpingGC = TRUE;
+  runParallelCopyWorker (s);
+  s->amHelpingGC = FALSE;
+}
+
+bool shouldParallelCheneyCopy (GC_state s, pointer toStart, pointer toLimit,
+                               size_t maxBytesLive) {
+  size_t slop;
+
+  unless (s->controls->parallelGC
+          and s->numberOfProcs > 1
+          and Proc_isSynchronized (s))
+    return FALSE;
+  /* Every LAB wastes at most 1/16 of its size, and each worker may be
+   * holding a partially filled LAB.
+   */
+  slop = maxBytesLive / 8
+    + 2 * (size_t)s->numberOfProcs * GC_PARALLEL_LAB_SIZE;
+  return (size_t)(toLimit - toStart) >= maxBytesLive + slop;
+}
+
+/* parallelCheneyCopy (s, toStart, toLimit, amInMinorGC)
+ *
+ * Forward everything reachable from the roots into to-space, starting
+ * at toStart, using all of the synchronized processors.  Returns the
+ * end of the copied data.  Weak objects found by any worker are
+ * linked into s->weaks.
+ */
+pointer parallelCheneyCopy (GC_state s, pointer toStart, pointer toLimit,
+                            bool amInMinorGC) {
+  if (NULL == parallelCopyWorkers) {
+    parallelCopyWorkers = (struct GC_parallelCopyWorker *)
+      calloc_safe (s->numberOfProcs, sizeof (struct GC_parallelCopyWorker));
+    parallelCopy.currentStacks = (GC_stack *)
+      malloc_safe (s->numberOfProcs * sizeof (GC_stack));
+    parallelCopy.rootTaskTaken = (volatile int32_t *)
+      calloc_safe (s->numberOfProcs, sizeof (int32_t));
+  }
+  if (DEBUG_PARALLEL_GC or s->controls->messages)
+    fprintf (stderr, "[GC: Starting parallel copy with %d workers.]\n",
+             s->numberOfProcs);
+  for (int proc = 0; proc < s->numberOfProcs; proc++) {
+    parallelCopy.currentStacks[proc] = getStackCurrent (&s->procStates[proc]);
+    parallelCopy.rootTaskTaken[proc] = 0;
+  }
+  parallelCopy.collector = s;
+  parallelCopy.forward = amInMinorGC
+    ? forwardObjptrIfInNurseryInParallel
+    : forwardObjptrInParallel;
+  parallelCopy.amInMinorGC = amInMinorGC;
+  parallelCopy.toStart = toStart;
+  parallelCopy.toLimit = toLimit;
+  parallelCopy.numWorkers = s->numberOfProcs;
+  parallelCopy.numTasks = s->numberOfProcs
+    + (int32_t)((s->globalsLength + GC_PARALLEL_GLOBALS_PER_TASK - 1)
+                / GC_PARALLEL_GLOBALS_PER_TASK);
+  parallelCopy.back = toStart;
+  parallelCopy.nextTask = 0;
+  parallelCopy.idle = 0;
+  parallelCopy.finished = 0;
+  __sync_synchronize ();
+  /* Publish the round; the other processors notice while spinning in
+   * Proc_beginCriticalSection or Proc_endCriticalSection.
+   */
+  parallelCopy.round++;
+  maybeHelpParallelCopy (s);
+  while (parallelCopy.finished < parallelCopy.numWorkers) { }
+
+  for (int proc = 0; proc < s->numberOfProcs; proc++) {
+    GC_state p = &s->procStates[proc];
+
+    if (p == s)
+      continue;
+    while (p->weaks != NULL) {
+      GC_weak w = p->weaks;
+
+      p->weaks = w->link;
+      w->link = s->weaks;
+      s->weaks = w;
+    }
+  }
+  s->forwardState.amInMinorGC = amInMinorGC;
+  s->forwardState.toStart = toStart;
+  s->forwardState.toLimit = toLimit;
+  s->cumulativeStatistics->numParallelGCs++;
+  if (DEBUG_PARALLEL_GC or s->controls->messages)
+    fprintf (stderr, "[GC: Finished parallel copy; copied %s bytes.]\n",
+             uintmaxToCommaString(parallelCopy.back - toStart));
+  return parallelCopy.back;
+}
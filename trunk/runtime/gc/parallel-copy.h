@@ -0,0 +1,67 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* Parallel Cheney copying.
+ *
+ * When the parallel-gc control is set, every processor that has
+ * synchronized for a collection helps trace and copy instead of
+ * spinning on its critical-section ticket.  Each worker copies into a
+ * private local allocation buffer (LAB) carved out of to-space.  Runs
+ * of copied-but-unscanned objects are pushed as ranges onto the
+ * worker's deque, from which idle workers steal.
+ */
+
+/* Size of the to-space chunk handed to a worker at a time. */
+#define GC_PARALLEL_LAB_SIZE (32 * 1024)
+/* Give away the unscanned part of our LAB once it gets this big and
+ * some other worker is idle.
+ */
+#define GC_PARALLEL_SPLIT_SIZE (4 * 1024)
+/* Number of global objptrs forwarded by a single root task. */
+#define GC_PARALLEL_GLOBALS_PER_TASK 1024
+
+/* Temporary header installed by the worker that won the race to copy
+ * an object.  The low bit is clear, so it is not a valid header.
+ */
+#define GC_BUSY (~((GC_header)1))
+
+struct GC_parallelCopyRange {
+  pointer front;
+  pointer back;
+};
+
+struct GC_parallelCopyDeque {
+  volatile int32_t lock;
+  struct GC_parallelCopyRange *ranges;
+  uint32_t capacity;
+  uint32_t bottom; /* thieves take from here */
+  uint32_t top; /* the owner pushes and pops here */
+};
+
+struct GC_parallelCopyWorker {
+  struct GC_parallelCopyDeque deque;
+  /* Objects copied into the LAB but not yet scanned are in
+   * [scan, s->forwardState.back).
+   */
+  pointer scan;
+  uint32_t lastRound; /* last round this processor helped with */
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static bool shouldParallelCheneyCopy (GC_state s, pointer toStart,
+                                      pointer toLimit, size_t maxBytesLive);
+static pointer parallelCheneyCopy (GC_state s, pointer toStart,
+                                   pointer toLimit, bool amInMinorGC);
+static void maybeHelpParallelCopy (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -0,0 +1,353 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* ---------------------------------------------------------------- */
+/*                     Parallel Hash Consing                        */
+/* ---------------------------------------------------------------- */
+
+/* State shared by all workers.  Everything but the canonical copies
+ * and the work counters is only written by the collector, before a
+ * round is published by bumping round.
+ */
+static struct {
+  volatile uint32_t round;
+  GC_state collector;
+  GC_parallelSharePhase phase;
+  GC_objectHashTable table;
+  bool isMarking; /* leave the objects marked, for the mark-compact GC */
+  /* The reachable objects, in postorder, and the canonical copy of
+   * each, which is NULL until the object has been hash consed.
+   */
+  pointer *objects;
+  pointer *canonical;
+  uint32_t numObjects;
+  uint32_t objectsCapacity;
+  struct GC_parallelShareIndexElem *index;
+  uint32_t indexLengthCur;
+  uint32_t indexLengthMax;
+  uint32_t indexLengthMaxLog2;
+  struct GC_parallelShareFrame *stack;
+  uint32_t stackTop;
+  uint32_t stackCapacity;
+  int32_t numWorkers;
+  volatile uint32_t nextChunk;
+  volatile int32_t finished;
+} parallelShare;
+
+static struct GC_parallelShareWorker *parallelShareWorkers = NULL;
+
+static inline uint32_t getParallelShareIndexSlot (pointer p) {
+  return (uint32_t)(UINT64_C(0x9E3779B9) * (uint64_t)((uintptr_t)p >> 2))
+    >> (32 - parallelShare.indexLengthMaxLog2);
+}
+
+/* Returns the index entry for p, or the empty entry where it goes. */
+static struct GC_parallelShareIndexElem *findParallelShareIndexElem (pointer p) {
+  struct GC_parallelShareIndexElem *e;
+  uint32_t slot;
+
+  slot = getParallelShareIndexSlot (p);
+  while (TRUE) {
+    e = &parallelShare.index[slot];
+    if (e->object == p or NULL == e->object)
+      return e;
+    slot = (slot + 1) & (parallelShare.indexLengthMax - 1);
+  }
+}
+
+static void growParallelShareIndex (void) {
+  struct GC_parallelShareIndexElem *oldIndex;
+  uint32_t oldIndexLengthMax;
+
+  oldIndex = parallelShare.index;
+  oldIndexLengthMax = parallelShare.indexLengthMax;
+  parallelShare.indexLengthMax *= 2;
+  parallelShare.indexLengthMaxLog2++;
+  parallelShare.index = (struct GC_parallelShareIndexElem *)
+    calloc_safe (parallelShare.indexLengthMax,
+                 sizeof (struct GC_parallelShareIndexElem));
+  for (uint32_t i = 0; i < oldIndexLengthMax; i++)
+    unless (NULL == oldIndex[i].object)
+      *findParallelShareIndexElem (oldIndex[i].object) = oldIndex[i];
+  free (oldIndex);
+}
+
+static inline uint32_t getParallelShareNumber (pointer p) {
+  struct GC_parallelShareIndexElem *e;
+
+  e = findParallelShareIndexElem (p);
+  assert (e->object == p);
+  return e->number;
+}
+
+static void pushParallelShareFrame (pointer p, bool isExpanded) {
+  if (parallelShare.stackTop == parallelShare.stackCapacity) {
+    parallelShare.stackCapacity *= 2;
+    parallelShare.stack = (struct GC_parallelShareFrame *)
+      realloc_safe (parallelShare.stack,
+                    parallelShare.stackCapacity
+                    * sizeof (struct GC_parallelShareFrame));
+  }
+  parallelShare.stack[parallelShare.stackTop].object = p;
+  parallelShare.stack[parallelShare.stackTop].isExpanded = isExpanded;
+  parallelShare.stackTop++;
+}
+
+static void pushParallelShareObjptr (GC_state s, objptr *opp) {
+  pointer p;
+
+  p = objptrToPointer (*opp, s->heap->start);
+  unless (isPointerMarked (p))
+    pushParallelShareFrame (p, FALSE);
+}
+
+bool shouldShareInParallel (GC_state s) {
+  return s->controls->parallelGC
+    and s->numberOfProcs > 1
+    and Proc_isSynchronized (s);
+}
+
+void beginParallelShare (__attribute__ ((unused)) GC_state s) {
+  parallelShare.numObjects = 0;
+  parallelShare.objectsCapacity = 1024;
+  parallelShare.objects = (pointer *)
+    malloc_safe (parallelShare.objectsCapacity * sizeof (pointer));
+  parallelShare.indexLengthCur = 0;
+  parallelShare.indexLengthMax = 2048;
+  parallelShare.indexLengthMaxLog2 = 11;
+  parallelShare.index = (struct GC_parallelShareIndexElem *)
+    calloc_safe (parallelShare.indexLengthMax,
+                 sizeof (struct GC_parallelShareIndexElem));
+  parallelShare.stackTop = 0;
+  parallelShare.stackCapacity = 1024;
+  parallelShare.stack = (struct GC_parallelShareFrame *)
+    malloc_safe (parallelShare.stackCapacity
+                 * sizeof (struct GC_parallelShareFrame));
+}
+
+/* The object *opp points to is hash consed, but *opp itself is left
+ * alone, as dfsMarkByMode does with its root.
+ */
+void addParallelShareRoot (GC_state s, objptr *opp) {
+  pushParallelShareObjptr (s, opp);
+}
+
+/* Number the objects reachable from the roots in postorder, marking
+ * them as they are reached, and, if isMarking, link the weaks into
+ * s->weaks, as dfsMarkWithHashConsWithLinkWeaks does.  Returns their
+ * total size.
+ */
+static size_t numberObjectsForParallelShare (GC_state s) {
+  struct GC_parallelShareIndexElem *e;
+  struct GC_parallelShareFrame f;
+  GC_header *headerp;
+  GC_objectTypeTag tag;
+  size_t size;
+
+  size = 0;
+  while (parallelShare.stackTop > 0) {
+    f = parallelShare.stack[--parallelShare.stackTop];
+    if (f.isExpanded) {
+      e = findParallelShareIndexElem (f.object);
+      assert (GC_PARALLEL_SHARE_UNFINISHED == e->number);
+      if (parallelShare.numObjects == parallelShare.objectsCapacity) {
+        parallelShare.objectsCapacity *= 2;
+        parallelShare.objects = (pointer *)
+          realloc_safe (parallelShare.objects,
+                        parallelShare.objectsCapacity * sizeof (pointer));
+      }
+      e->number = parallelShare.numObjects;
+      parallelShare.objects[parallelShare.numObjects++] = f.object;
+      continue;
+    }
+    headerp = getHeaderp (f.object);
+    if (MARK_MASK & *headerp)
+      continue;
+    *headerp |= MARK_MASK;
+    if (2 * (parallelShare.indexLengthCur + 1) > parallelShare.indexLengthMax)
+      growParallelShareIndex ();
+    e = findParallelShareIndexElem (f.object);
+    e->object = f.object;
+    e->number = GC_PARALLEL_SHARE_UNFINISHED;
+    parallelShare.indexLengthCur++;
+    size += sizeofObject (s, f.object);
+    pushParallelShareFrame (f.object, TRUE);
+    splitHeader (s, *headerp, &tag, NULL, NULL, NULL);
+    if (parallelShare.isMarking and WEAK_TAG == tag) {
+      GC_weak w;
+
+      w = (GC_weak)(f.object + offsetofWeak (s));
+      if (isObjptr (w->objptr)) {
+        w->link = s->weaks;
+        s->weaks = w;
+      }
+    }
+    /* Weak objects don't keep what they point to, so they are left
+     * alone, as by dfsMarkByMode.
+     */
+    foreachObjptrInObject (s, f.object, pushParallelShareObjptr, TRUE);
+  }
+  return size;
+}
+
+/* Point *opp at the canonical copy of its object, if that comes
+ * earlier in postorder than the object being worked on.
+ */
+static void shareObjptrInParallel (GC_state s, objptr *opp) {
+  struct GC_parallelShareWorker *w;
+  pointer p, c;
+  uint32_t number;
+
+  w = &parallelShareWorkers[s - s->procStates];
+  p = objptrToPointer (*opp, s->heap->start);
+  number = getParallelShareNumber (p);
+  if (number >= w->current)
+    return;
+  while (NULL == (c = parallelShare.canonical[number]))
+    __sync_synchronize ();
+  if (c != p) {
+    *opp = pointerToObjptr (c, s->heap->start);
+    markIntergenerationalObjptr (parallelShare.collector, opp);
+  }
+}
+
+/* Point *opp at the canonical copy of its object, if that comes
+ * at or after the object being worked on.
+ */
+static void fixBackEdgeInParallel (GC_state s, objptr *opp) {
+  struct GC_parallelShareWorker *w;
+  pointer p, c;
+  uint32_t number;
+
+  w = &parallelShareWorkers[s - s->procStates];
+  p = objptrToPointer (*opp, s->heap->start);
+  number = getParallelShareNumber (p);
+  if (number < w->current)
+    return;
+  c = parallelShare.canonical[number];
+  if (c != p) {
+    *opp = pointerToObjptr (c, s->heap->start);
+    markIntergenerationalObjptr (parallelShare.collector, opp);
+  }
+}
+
+static void runParallelShareWorker (GC_state s) {
+  struct GC_parallelShareWorker *w;
+  uint32_t first, last;
+
+  w = &parallelShareWorkers[s - s->procStates];
+  if (DEBUG_PARALLEL_GC)
+    fprintf (stderr, "[GC: Joining parallel share round %"PRIu32".] [%d]\n",
+             parallelShare.round, Proc_processorNumber (s));
+  /* Chunks are handed out in order, so the lowest numbered unfinished
+   * object is always being worked on, and everything it waits for is
+   * done.
+   */
+  while ((first = __sync_fetch_and_add (&parallelShare.nextChunk,
+                                        GC_PARALLEL_SHARE_CHUNK))
+         < parallelShare.numObjects) {
+    last = min (first + GC_PARALLEL_SHARE_CHUNK, parallelShare.numObjects);
+    for (uint32_t i = first; i < last; i++) {
+      pointer p;
+
+      p = parallelShare.objects[i];
+      w->current = i;
+      if (GC_PARALLEL_SHARE_HASH_CONS == parallelShare.phase) {
+        foreachObjptrInObject (s, p, shareObjptrInParallel, TRUE);
+        p = hashConsPointerInParallel (s, parallelShare.table, p,
+                                       &w->bytesHashConsed);
+        __sync_synchronize ();
+        parallelShare.canonical[i] = p;
+      } else {
+        assert (GC_PARALLEL_SHARE_FIX_BACK_EDGES == parallelShare.phase);
+        foreachObjptrInObject (s, p, fixBackEdgeInParallel, TRUE);
+        unless (parallelShare.isMarking)
+          *getHeaderp (p) &= ~MARK_MASK;
+      }
+    }
+  }
+  __sync_fetch_and_add (&parallelShare.finished, 1);
+}
+
+/* Called by processors waiting for the runtime; joins the current
+ * round of parallel hash consing if there is one that we haven't
+ * helped with yet.
+ */
+void maybeHelpParallelShare (GC_state s) {
+  struct GC_parallelShareWorker *w;
+  uint32_t round;
+
+  round = parallelShare.round;
+  if (0 == round)
+    return;
+  w = &parallelShareWorkers[Proc_processorNumber (s)];
+  if (w->lastRound == round)
+    return;
+  w->lastRound = round;
+  __sync_synchronize ();
+  s->amHelpingGC = TRUE;
+  runParallelShareWorker (s);
+  s->amHelpingGC = FALSE;
+}
+
+static void runParallelShareRound (GC_state s, GC_parallelSharePhase phase) {
+  parallelShare.phase = phase;
+  parallelShare.nextChunk = 0;
+  parallelShare.finished = 0;
+  __sync_synchronize ();
+  /* Publish the round; the other processors notice while spinning in
+   * Proc_beginCriticalSection or Proc_endCriticalSection.
+   */
+  parallelShare.round++;
+  maybeHelpParallelShare (s);
+  while (parallelShare.finished < parallelShare.numWorkers) { }
+}
+
+/* shareInParallel (s, isMarking)
+ *
+ * Hash cons everything reachable from the roots added since
+ * beginParallelShare, using all of the synchronized processors.  If
+ * isMarking, everything reached is left marked and the weaks are
+ * linked, so that this is the marking for the mark-compact GC;
+ * otherwise the marks are cleared again.  Returns the total size of
+ * the objects examined; the bytes saved are added to
+ * s->lastMajorStatistics->bytesHashConsed.
+ */
+size_t shareInParallel (GC_state s, bool isMarking) {
+  size_t bytesExamined;
+
+  if (NULL == parallelShareWorkers)
+    parallelShareWorkers = (struct GC_parallelShareWorker *)
+      calloc_safe (s->numberOfProcs, sizeof (struct GC_parallelShareWorker));
+  parallelShare.isMarking = isMarking;
+  bytesExamined = numberObjectsForParallelShare (s);
+  free (parallelShare.stack);
+  if (DEBUG_PARALLEL_GC or DEBUG_SHARE or s->controls->messages)
+    fprintf (stderr,
+             "[GC: Starting parallel hash consing of %s objects with %d workers.]\n",
+             uintmaxToCommaString(parallelShare.numObjects),
+             s->numberOfProcs);
+  parallelShare.canonical = (pointer *)
+    calloc_safe (max (parallelShare.numObjects, 1), sizeof (pointer));
+  parallelShare.table = allocHashTable (s);
+  reserveHashTable (s, parallelShare.table, parallelShare.numObjects);
+  parallelShare.collector = s;
+  parallelShare.numWorkers = s->numberOfProcs;
+  for (int proc = 0; proc < s->numberOfProcs; proc++)
+    parallelShareWorkers[proc].bytesHashConsed = 0;
+  runParallelShareRound (s, GC_PARALLEL_SHARE_HASH_CONS);
+  runParallelShareRound (s, GC_PARALLEL_SHARE_FIX_BACK_EDGES);
+  for (int proc = 0; proc < s->numberOfProcs; proc++)
+    s->lastMajorStatistics->bytesHashConsed +=
+      parallelShareWorkers[proc].bytesHashConsed;
+  freeHashTable (parallelShare.table);
+  free (parallelShare.canonical);
+  free (parallelShare.index);
+  free (parallelShare.objects);
+  return bytesExamined;
+}
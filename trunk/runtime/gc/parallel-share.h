@@ -0,0 +1,67 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* Parallel hash consing.
+ *
+ * When the parallel-gc control is set and the processors have
+ * synchronized, MLton.share and hash consing during a major GC use
+ * every processor instead of dfsMarkByMode.  The collector first
+ * numbers the reachable objects in depth-first postorder, marking them
+ * as it goes, which for a major GC is all of the marking.  Then, in a round of work handed out in
+ * chunks of that order, each worker points the fields of an object at
+ * the canonical copies of its children and inserts the object into a
+ * shared lock-free table.  A child numbered before its parent is
+ * always finished first, so a worker that gets to it too soon just
+ * waits; a child numbered after (an edge back up the depth-first
+ * tree) is left alone until a second round, when every object is
+ * done.
+ */
+
+/* Number of objects handed to a worker at a time. */
+#define GC_PARALLEL_SHARE_CHUNK 256
+/* Number of an object that has been reached but not finished. */
+#define GC_PARALLEL_SHARE_UNFINISHED UINT32_MAX
+
+typedef enum {
+  GC_PARALLEL_SHARE_HASH_CONS,
+  GC_PARALLEL_SHARE_FIX_BACK_EDGES,
+} GC_parallelSharePhase;
+
+/* The index maps an object to its number. */
+struct GC_parallelShareIndexElem {
+  pointer object;
+  uint32_t number;
+};
+
+/* An object on the depth-first stack, which is finished when it is
+ * popped the second time.
+ */
+struct GC_parallelShareFrame {
+  pointer object;
+  bool isExpanded;
+};
+
+struct GC_parallelShareWorker {
+  uint32_t lastRound; /* last round this processor helped with */
+  uint32_t current; /* number of the object being worked on */
+  size_t bytesHashConsed;
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static bool shouldShareInParallel (GC_state s);
+static void beginParallelShare (GC_state s);
+static void addParallelShareRoot (GC_state s, objptr *opp);
+static size_t shareInParallel (GC_state s, bool isMarking);
+static void maybeHelpParallelShare (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -5,18 +5,48 @@
 
 /* num of holding thread or -1 if no one*/
 volatile int32_t *Parallel_mutexes;
-pthread_mutex_t *waitMutex;
-pthread_cond_t *waitCondVar;
-bool* dataInMutatorQ;
+/* num of threads parked (or about to park) on each mutex */
+volatile int32_t *Parallel_mutexWaiters;
+/* Bumped by every unlock of each mutex and every rendezvous; waiters
+ * park on it */
+volatile int32_t *Parallel_mutexSeqs;
+struct Parallel_lockStatistics *Parallel_lockStatistics;
+/* Eventcount bumped by every wake up of each processor */
+volatile int32_t *Parallel_waitEpoch;
+/* Whether each processor is parked (or about to park) in Parallel_wait */
+volatile int32_t *Parallel_parked;
+/* Number of processors parked in Parallel_wait */
+volatile int32_t Parallel_numParked;
+/* Number of compute processors among them */
+volatile int32_t Parallel_numIdle;
+volatile bool *dataInMutatorQ;
+/* The node of each processor, or -1 if unknown */
+int32_t *Parallel_nodes;
+/* Each I/O processor's reactor; fd is -1 for the others */
+struct GC_reactor *Parallel_reactors;
 
 void Parallel_init (void) {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
 
   if (!Proc_isInitialized (s)) {
     Parallel_mutexes = (int32_t *) malloc (s->numberOfProcs * sizeof (int32_t));
-    waitMutex = (pthread_mutex_t*) malloc (s->numberOfProcs * sizeof (pthread_mutex_t));
-    waitCondVar = (pthread_cond_t*) malloc (s->numberOfProcs * sizeof (pthread_cond_t));
+    Parallel_mutexWaiters =
+      (int32_t *) calloc_safe (s->numberOfProcs, sizeof (int32_t));
+    Parallel_mutexSeqs =
+      (int32_t *) calloc_safe (s->numberOfProcs, sizeof (int32_t));
+    Parallel_lockStatistics = (struct Parallel_lockStatistics *)
+      calloc_safe (s->numberOfProcs, sizeof (struct Parallel_lockStatistics));
+    Parallel_waitEpoch =
+      (int32_t *) calloc_safe (s->numberOfProcs, sizeof (int32_t));
+    Parallel_parked =
+      (int32_t *) calloc_safe (s->numberOfProcs, sizeof (int32_t));
+    Parallel_numParked = 0;
+    Parallel_numIdle = 0;
     dataInMutatorQ = (bool*) malloc (s->numberOfProcs * sizeof(bool));
+    Parallel_reactors = (struct GC_reactor *)
+      malloc_safe (s->numberOfProcs * sizeof (struct GC_reactor));
+    Parallel_nodes =
+      (int32_t *) malloc_safe (s->numberOfProcs * sizeof (int32_t));
 
 
     /* Set up call-back state in each worker thread */
@@ -29,11 +59,17 @@ void Parallel_init (void) {
         s->heap->start);
 
       Parallel_mutexes[proc] = -1;
-      pthread_mutex_init (&waitMutex[proc], NULL);
-      pthread_cond_init (&waitCondVar[proc], NULL);
       /* To be on the safe side initialize dataInMutatorQ with true. This will be cleared
        * on the first iteration if it is a false positive */
       dataInMutatorQ[proc] = TRUE;
+      Parallel_reactors[proc].fd = -1;
+      Parallel_reactors[proc].wakeFd = -1;
+      Parallel_nodes[proc] = numaNodeOfProcessor (s, proc);
+      if (proc >= s->numberOfProcs - s->numIOThreads
+          and not GC_reactorCreate (&Parallel_reactors[proc])
+          and s->controls->messages)
+        fprintf (stderr, "[GC: No reactor for processor %d (%s).]\n",
+                 proc, strerror (errno));
     }
     /* Now wake them up! */
     Proc_signalInitialization (s);
@@ -41,33 +77,33 @@ void Parallel_init (void) {
 }
 
 Int32 Parallel_processorNumber (void) {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   return Proc_processorNumber (s);
 }
 
 Int32 Parallel_numberOfProcessors (void) {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   return s->numberOfProcs;
 }
 
 Int32 Parallel_numIOThreads (void) {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   return s->numIOThreads;
 }
 
 Word64 Parallel_maxBytesLive (void) {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   return (uint64_t)s->cumulativeStatistics->maxBytesLiveSinceReset;
 }
 
 void Parallel_resetBytesLive (void) {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   s->cumulativeStatistics->maxBytesLiveSinceReset = 0;
 }
 
 
 void Parallel_maybeWaitForGC (void) {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   if (Proc_threadInSection (s)) {
     //fprintf (stderr, "waiting for gc [%d]\n", Proc_processorNumber (s));
 
@@ -77,44 +113,125 @@ void Parallel_maybeWaitForGC (void) {
   }
 }
 
-//struct rusage ru_lock;
+static inline void Parallel_relax (void) {
+#if (defined (__i386__) || defined (__x86_64__))
+  __asm__ __volatile__ ("pause" : : : "memory");
+#else
+  __asm__ __volatile__ ("" : : : "memory");
+#endif
+}
+
+static inline uintmax_t Parallel_nanoseconds (void) {
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uintmax_t)ts.tv_sec * 1000000000 + (uintmax_t)ts.tv_nsec;
+}
+
+/* Sleep until lock p changes hands, we are needed for a rendezvous, or
+ * the timeout expires.  We read the lock's sequence word before
+ * announcing ourselves in Parallel_mutexWaiters and rechecking.
+ * Parallel_unlock and Parallel_wakeLockWaiters bump the word after
+ * changing their own state and before checking the count.  So either
+ * we see their change, or the futex sees the new word and does not
+ * sleep, or they see us and wake us.
+ */
+static void Parallel_park (GC_state s, Int32 p, int32_t holder) {
+  int32_t seq = Parallel_mutexSeqs[p];
+
+  __sync_fetch_and_add (&Parallel_mutexWaiters[p], 1);
+  if (Parallel_mutexes[p] == holder and not Proc_threadInSection (s)) {
+    if (s->controls->summary)
+      __sync_fetch_and_add (&Parallel_lockStatistics[p].parked, 1);
+    GC_futexWait (&Parallel_mutexSeqs[p], seq, PARALLEL_LOCK_PARK_TIMEOUT);
+  }
+  __sync_fetch_and_sub (&Parallel_mutexWaiters[p], 1);
+}
+
+/* Wake every parked waiter, so that they can join a rendezvous. */
+void Parallel_wakeLockWaiters (GC_state s) {
+  if (NULL == Parallel_mutexWaiters)
+    return;
+  for (int32_t p = 0; p < s->numberOfProcs; p++) {
+    __sync_fetch_and_add (&Parallel_mutexSeqs[p], 1);
+    if (Parallel_mutexWaiters[p] > 0)
+      GC_futexWake (&Parallel_mutexSeqs[p], INT32_MAX);
+  }
+}
 
+/* Spin with exponential backoff for a bounded time, then park. */
 void Parallel_lock (Int32 p) {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   int32_t myNumber = Proc_processorNumber (s);
+  uint32_t round = 0;
+  bool contended = FALSE;
 
-  //fprintf (stderr, "lock\n");
-
-  /*
-  if (needGCTime (s))
-    startTiming (&ru_lock);
-  */
+  while (TRUE) {
+    int32_t holder;
 
-  do {
-  AGAIN:
     Parallel_maybeWaitForGC ();
-    if (Parallel_mutexes[p] >= 0)
-      goto AGAIN;
-  } while (not __sync_bool_compare_and_swap (&Parallel_mutexes[p],
-                                             -1,
-                                             myNumber));
-  /*
-  if (needGCTime (s))
-    stopTiming (&ru_lock, &s->cumulativeStatistics->ru_lock);
-  */
+    holder = Parallel_mutexes[p];
+    if (holder < 0) {
+      if (__sync_bool_compare_and_swap (&Parallel_mutexes[p], -1, myNumber))
+        break;
+      contended = TRUE;
+      continue;
+    }
+    contended = TRUE;
+    if (round < PARALLEL_LOCK_SPIN_ROUNDS) {
+      for (uint32_t i = 0; i < ((uint32_t)1 << round); i++)
+        Parallel_relax ();
+      round++;
+    } else
+      Parallel_park (s, p, holder);
+  }
+
+  if (s->controls->summary) {
+    /* Only the holder writes these. */
+    Parallel_lockStatistics[p].acquired++;
+    if (contended)
+      Parallel_lockStatistics[p].contended++;
+    Parallel_lockStatistics[p].acquiredAt = Parallel_nanoseconds ();
+  }
 }
 
 void Parallel_unlock (Int32 p) {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   int32_t myNumber = Proc_processorNumber (s);
 
   //fprintf (stderr, "unlock %d\n", Parallel_holdingMutex);
 
+  if (s->controls->summary and Parallel_mutexes[p] == myNumber)
+    Parallel_lockStatistics[p].holdTime +=
+      Parallel_nanoseconds () - Parallel_lockStatistics[p].acquiredAt;
   if (not __sync_bool_compare_and_swap (&Parallel_mutexes[p],
                                         myNumber,
                                         -1)) {
     fprintf (stderr, "can't unlock if you don't hold the lock\n");
   }
+  else {
+    __sync_fetch_and_add (&Parallel_mutexSeqs[p], 1);
+    if (Parallel_mutexWaiters[p] > 0)
+      GC_futexWake (&Parallel_mutexSeqs[p], 1);
+  }
+}
+
+void Parallel_displayLockStatistics (GC_state s, FILE *stream) {
+  if (NULL == Parallel_lockStatistics)
+    return;
+  for (int32_t p = 0; p < s->numberOfProcs; p++) {
+    struct Parallel_lockStatistics *l = &Parallel_lockStatistics[p];
+
+    if (0 == l->acquired)
+      continue;
+    fprintf (stream, "lock %"PRId32": %s acquired, %s contended, %s parked, ",
+             p,
+             uintmaxToCommaString (l->acquired),
+             uintmaxToCommaString (l->contended),
+             uintmaxToCommaString (l->parked));
+    fprintf (stream, "%s ms held\n",
+             uintmaxToCommaString (l->holdTime / 1000000));
+  }
 }
 
 Int32 Parallel_fetchAndAdd (pointer p, Int32 v) {
@@ -142,15 +259,19 @@ Int32 Parallel_vCompareAndSwap (pointer p, Int32 old, Int32 new) {
     return __sync_val_compare_and_swap ((Int32 *)p, old, new);
 }
 
+bool Parallel_compareAndSwap64 (pointer p, Int64 old, Int64 new) {
+  return __sync_bool_compare_and_swap ((Int64 *)p, old, new);
+}
+
 void Parallel_enablePreemption (void)
 {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   sigaddset(&s->signalsInfo.signalsHandled, SIGALRM);
 }
 
 void Parallel_disablePreemption (void)
 {
-  GC_state s = pthread_getspecific (gcstate_key);
+  GC_state s = Proc_getCurrentState ();
   sigdelset(&s->signalsInfo.signalsHandled, SIGALRM);
   sigdelset(&s->signalsInfo.signalsPending, SIGALRM);
 }
@@ -182,31 +303,145 @@ timeval_diff(struct timeval *difference,
 
 } /* timeval_diff() */
 
+/* Idle processors park on their own eventcount.  A processor first
+ * reads its epoch and announces itself in Parallel_parked, then
+ * rechecks whether it has work.  Wakers publish the work first and
+ * then look at Parallel_parked, so one side always sees the other; a
+ * wake up that slips in between reading the epoch and sleeping
+ * changes the epoch, so the futex wait returns at once.  Running
+ * processors are never touched, and a rendezvous with nobody parked
+ * costs a single read of Parallel_numParked.
+ */
+static inline bool Parallel_hasWork (GC_state s, int p) {
+  return Proc_threadInSection (s) or dataInMutatorQ[p];
+}
+
 void Parallel_wait (void) {
-    GC_state s = pthread_getspecific (gcstate_key);
-    int p = Parallel_processorNumber ();
+    GC_state s = Proc_getCurrentState ();
+    int p = Proc_processorNumber (s);
+    bool compute = p < s->numberOfProcs - s->numIOThreads;
+    int32_t epoch;
     sigset_t set;
     sigemptyset (&set);
     sigaddset (&set, SIGUSR2);
-    //struct timeval starttime,endtime,timediff;
 
-    //gettimeofday(&starttime,0x0);
-    pthread_mutex_lock (&waitMutex[p]);
-    if (!(Proc_threadInSection (s) || dataInMutatorQ[p])) {
+    epoch = Parallel_waitEpoch[p];
+    Parallel_parked[p] = TRUE;
+    __sync_fetch_and_add (&Parallel_numParked, 1);
+    if (compute)
+      __sync_fetch_and_add (&Parallel_numIdle, 1);
+    if (not Parallel_hasWork (s, p)) {
         pthread_sigmask (SIG_BLOCK, &set, NULL);
-        pthread_cond_wait (&waitCondVar[p], &waitMutex[p]);
+        while (Parallel_waitEpoch[p] == epoch and not Parallel_hasWork (s, p))
+          GC_futexWait (&Parallel_waitEpoch[p], epoch, PARALLEL_WAIT_TIMEOUT);
         pthread_sigmask (SIG_UNBLOCK, &set, NULL);
     }
+    Parallel_parked[p] = FALSE;
+    __sync_fetch_and_sub (&Parallel_numParked, 1);
+    if (compute)
+      __sync_fetch_and_sub (&Parallel_numIdle, 1);
+    dataInMutatorQ[p] = FALSE;
+}
+
+/* An I/O processor with nothing to run parks in its reactor instead,
+ * so that readiness of a file descriptor also wakes it.  It announces
+ * itself in Parallel_parked just as Parallel_wait does, and a wake up
+ * that comes before it is in the kernel leaves the reactor's wake up
+ * pending, so the wait returns at once.  With a timeout of 0 it only
+ * polls, and does not park.
+ */
+Int32 Parallel_reactorWait (Int32 timeout, uint32_t *tokens, uint32_t *events,
+                            Int32 max) {
+    GC_state s = Proc_getCurrentState ();
+    int p = Proc_processorNumber (s);
+    struct GC_reactor *r = &Parallel_reactors[p];
+    int res;
+    sigset_t set;
+
+    if (r->fd < 0) {
+      errno = ENOSYS;
+      return -1;
+    }
+    if (0 == timeout)
+      return GC_reactorWait (r, 0, tokens, events, max);
+    if (timeout < 0 or timeout > PARALLEL_WAIT_TIMEOUT / 1000)
+      timeout = PARALLEL_WAIT_TIMEOUT / 1000;
+    sigemptyset (&set);
+    sigaddset (&set, SIGUSR2);
+    Parallel_parked[p] = TRUE;
+    __sync_fetch_and_add (&Parallel_numParked, 1);
+    if (Parallel_hasWork (s, p))
+      timeout = 0;
+    pthread_sigmask (SIG_BLOCK, &set, NULL);
+    res = GC_reactorWait (r, timeout, tokens, events, max);
+    pthread_sigmask (SIG_UNBLOCK, &set, NULL);
+    Parallel_parked[p] = FALSE;
+    __sync_fetch_and_sub (&Parallel_numParked, 1);
     dataInMutatorQ[p] = FALSE;
-    pthread_mutex_unlock (&waitMutex[p]);
-    //gettimeofday(&endtime,0x0);
-    //long long diff = timeval_diff(&timediff,&endtime,&starttime);
-    //fprintf(stderr, "Diff %lld[%d]\n", diff, Parallel_processorNumber ());
+    return res;
+}
+
+/* The reactor of I/O processor p, or NULL if it has none. */
+struct GC_reactor *Parallel_reactor (Int32 p) {
+    GC_state s = Proc_getCurrentState ();
+
+    if (p < 0 or p >= s->numberOfProcs or Parallel_reactors[p].fd < 0)
+      return NULL;
+    return &Parallel_reactors[p];
+}
+
+static inline void Parallel_unpark (Int32 p) {
+    __sync_fetch_and_add (&Parallel_waitEpoch[p], 1);
+    GC_futexWake (&Parallel_waitEpoch[p], 1);
+    if (Parallel_reactors[p].fd >= 0)
+      GC_reactorWake (&Parallel_reactors[p]);
 }
 
 void Parallel_wakeUpThread (Int32 p, Int32 dataIn) {
-    pthread_mutex_lock (&waitMutex[p]);
     if (dataIn == 1) dataInMutatorQ[p] = TRUE;
-    pthread_cond_signal (&waitCondVar[p]);
-    pthread_mutex_unlock (&waitMutex[p]);
+    __sync_synchronize ();
+    if (Parallel_parked[p])
+      Parallel_unpark (p);
+}
+
+/* Wake one compute processor parked in Parallel_wait, preferring one on
+ * the same node as p, so that it can steal the work p has just queued.
+ */
+void Parallel_wakeIdleProcessor (Int32 p) {
+    GC_state s = Proc_getCurrentState ();
+    int32_t numComputeProcs = s->numberOfProcs - s->numIOThreads;
+    int32_t node = Parallel_nodes[p];
+    int32_t far = -1;
+
+    __sync_synchronize ();
+    if (Parallel_numIdle == 0)
+      return;
+    for (int32_t q = 0; q < numComputeProcs; q++) {
+      if (q == p or not Parallel_parked[q])
+        continue;
+      if (node < 0 or Parallel_nodes[q] == node) {
+        Parallel_unpark (q);
+        return;
+      }
+      if (far < 0)
+        far = q;
+    }
+    if (far >= 0)
+      Parallel_unpark (far);
+}
+
+Int32 Parallel_nodeOfProcessor (Int32 p) {
+  return Parallel_nodes[p];
+}
+
+/* Wake the processors parked in Parallel_wait, so that they can join a
+ * rendezvous.  Our caller has already entered the critical section.
+ */
+void Parallel_wakeParkedProcessors (GC_state s) {
+    __sync_synchronize ();
+    if (Parallel_numParked == 0)
+      return;
+    for (int p = 0; p < s->numberOfProcs; p++)
+      if (Parallel_parked[p])
+        Parallel_unpark (p);
 }
@@ -1,3 +1,35 @@
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* Number of backoff rounds Parallel_lock spins before it parks; the
+ * pause loop doubles in length each round.
+ */
+#define PARALLEL_LOCK_SPIN_ROUNDS 10
+/* Longest a parked waiter sleeps before rechecking (in microseconds). */
+#define PARALLEL_LOCK_PARK_TIMEOUT 10000
+/* Longest an idle processor sleeps in Parallel_wait before rechecking
+ * (in microseconds).  Only a safety net; wake ups are explicit.
+ */
+#define PARALLEL_WAIT_TIMEOUT 1000000
+
+/* Per-lock counters, gathered only when gc-summary is on. */
+struct Parallel_lockStatistics {
+  uintmax_t acquired;
+  uintmax_t contended; /* acquisitions that found the lock taken */
+  uintmax_t parked; /* times a waiter slept in the kernel */
+  uintmax_t holdTime; /* in nanoseconds */
+  uintmax_t acquiredAt;
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+void Parallel_wakeLockWaiters (GC_state s);
+void Parallel_wakeParkedProcessors (GC_state s);
+void Parallel_displayLockStatistics (GC_state s, FILE *stream);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
+
 
 #if (defined (MLTON_GC_INTERNAL_BASIS))
 
@@ -15,6 +47,7 @@ void Parallel_resetBytesLive (void);
 Int32 Parallel_fetchAndAdd (pointer p, Int32 v);
 bool Parallel_compareAndSwap (pointer p, Int32 old, Int32 new);
 Int32 Parallel_vCompareAndSwap (pointer p, Int32 old, Int32 new);
+bool Parallel_compareAndSwap64 (pointer p, Int64 old, Int64 new);
 
 void Parallel_maybeWaitForGC (void);
 
@@ -22,6 +55,8 @@ void Parallel_disablePreemption (void);
 void Parallel_enablePreemption (void);
 void Parallel_wait (void);
 void Parallel_wakeUpThread (Int32 p, Int32 dataIn);
+void Parallel_wakeIdleProcessor (Int32 p);
+Int32 Parallel_nodeOfProcessor (Int32 p);
 
 long long
 timeval_diff(struct timeval *difference,
@@ -30,3 +65,7 @@ timeval_diff(struct timeval *difference,
 
 #endif /* (defined (MLTON_GC_INTERNAL_BASIS)) */
 
+/* For MLton.Reactor in the basis. */
+PRIVATE Int32 Parallel_reactorWait (Int32 timeout, uint32_t *tokens,
+                                    uint32_t *events, Int32 max);
+PRIVATE struct GC_reactor *Parallel_reactor (Int32 p);
@@ -0,0 +1,200 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+static struct {
+  volatile int lock; /* taken by allocation and the sweep */
+  pointer start; /* NULL until the first buffer is allocated */
+  pointer frontier; /* blocks lie in [start, frontier) */
+  pointer end;
+  GC_pinnedBlock free; /* free blocks, in address order */
+  bool isMarking; /* from clearPinnedMarks to sweepPinned */
+} pinned;
+
+static inline void lockPinned (void) {
+  while (__sync_lock_test_and_set (&pinned.lock, 1))
+    while (pinned.lock)
+      ;
+}
+
+static inline void unlockPinned (void) {
+  __sync_lock_release (&pinned.lock);
+}
+
+static inline pointer pinnedBlockToPointer (GC_pinnedBlock b) {
+  return (pointer)b + GC_PINNED_BLOCK_ALIGN;
+}
+
+bool isPointerPinned (pointer p) {
+  return pinned.start <= p and p < pinned.end;
+}
+
+bool isObjptrPinned (GC_state s, objptr op) {
+  return isPointerPinned (objptrToPointer (op, s->heap->start));
+}
+
+/* Buffers have no object pointers in them, so marking is only the
+ * one bit.  Collector threads may race to set it, which is harmless.
+ * Outside of a major GC's marking, there is nothing to do.
+ */
+void markPinnedObjptr (GC_state s, objptr op) {
+  GC_header *headerp;
+
+  unless (pinned.isMarking)
+    return;
+  headerp = getHeaderp (objptrToPointer (op, s->heap->start));
+  unless (MARK_MASK & *headerp)
+    *headerp |= MARK_MASK;
+}
+
+bool hasPinnedBuffers (void) {
+  GC_pinnedBlock b;
+
+  for (pointer p = pinned.start; p < pinned.frontier; p += b->size) {
+    b = (GC_pinnedBlock)p;
+    if (BOGUS_OBJPTR != b->buffer)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/* clearPinnedMarks ()
+ *
+ * Called with the world stopped when the marking for a major GC
+ * starts, so that the sweep after it sees only its marks.
+ */
+void clearPinnedMarks (void) {
+  GC_pinnedBlock b;
+
+  for (pointer p = pinned.start; p < pinned.frontier; p += b->size) {
+    b = (GC_pinnedBlock)p;
+    if (BOGUS_OBJPTR != b->buffer)
+      *getHeaderp (pinnedBlockToPointer (b)) &= ~MARK_MASK;
+  }
+  pinned.isMarking = TRUE;
+}
+
+/* sweepPinned (s)
+ *
+ * Frees the buffers that the major GC just finished didn't mark and
+ * that aren't new, and rebuilds the free list, merging neighbors.
+ * Free space at the end of the region goes back to the frontier.
+ */
+void sweepPinned (GC_state s) {
+  GC_pinnedBlock b;
+  GC_pinnedBlock *freep, *lastFreep;
+  GC_header *headerp;
+  size_t bytesFreed;
+
+  unless (pinned.isMarking)
+    return;
+  pinned.isMarking = FALSE;
+  if (NULL == pinned.start)
+    return;
+  lockPinned ();
+  bytesFreed = 0;
+  freep = &pinned.free;
+  lastFreep = NULL; /* points to the free block just before b, if any */
+  for (pointer p = pinned.start; p < pinned.frontier; p += b->size) {
+    b = (GC_pinnedBlock)p;
+    if (BOGUS_OBJPTR != b->buffer) {
+      headerp = getHeaderp (pinnedBlockToPointer (b));
+      if (b->isNew or (MARK_MASK & *headerp)) {
+        lastFreep = NULL;
+        continue;
+      }
+      b->buffer = BOGUS_OBJPTR;
+      bytesFreed += b->size;
+    }
+    if (NULL != lastFreep) {
+      /* Merge; b->size stays valid for the loop. */
+      (*lastFreep)->size += b->size;
+    } else {
+      *freep = b;
+      lastFreep = freep;
+      freep = &b->next;
+    }
+  }
+  *freep = NULL;
+  if (NULL != lastFreep) {
+    pinned.frontier = (pointer)*lastFreep;
+    *lastFreep = NULL;
+  }
+  unlockPinned ();
+  if (DEBUG or s->controls->messages)
+    fprintf (stderr, "[GC: Freed %s bytes of pinned buffers.]\n",
+             uintmaxToCommaString (bytesFreed));
+}
+
+/* GC_pinnedAlloc (gs, bytes)
+ *
+ * Allocates a pinned buffer of the given length and returns a pointer
+ * to the objptr of it, or NULL if the region is full.  The buffer is
+ * new, so it survives the major GCs that come before the caller has
+ * fetched it and called GC_pinnedFetched.  The contents are not
+ * cleared.
+ */
+pointer GC_pinnedAlloc (__attribute__ ((unused)) GC_state *gs, size_t bytes) {
+  GC_state s = Proc_getCurrentState ();
+  GC_pinnedBlock b, r, *prevp;
+  size_t size;
+  pointer p;
+
+  size = align (GC_PINNED_BLOCK_ALIGN + bytes, GC_PINNED_BLOCK_ALIGN);
+  if (size < bytes)
+    return NULL;
+  lockPinned ();
+  if (NULL == pinned.start) {
+    pinned.start = GC_mmapAnon_safe (NULL, s->controls->pinnedSize);
+    pinned.frontier = pinned.start;
+    pinned.end = pinned.start + s->controls->pinnedSize;
+    pinned.free = NULL;
+  }
+  for (prevp = &pinned.free; NULL != (b = *prevp); prevp = &b->next)
+    if (b->size >= size)
+      break;
+  if (NULL != b) {
+    if (b->size > size) {
+      r = (GC_pinnedBlock)((pointer)b + size);
+      r->size = b->size - size;
+      r->buffer = BOGUS_OBJPTR;
+      r->next = b->next;
+      b->size = size;
+      *prevp = r;
+    } else
+      *prevp = b->next;
+  } else if (size <= (size_t)(pinned.end - pinned.frontier)) {
+    b = (GC_pinnedBlock)pinned.frontier;
+    b->size = size;
+    pinned.frontier += size;
+  } else {
+    unlockPinned ();
+    return NULL;
+  }
+  p = pinnedBlockToPointer (b);
+  *getArrayCounterp (p) = 0;
+  *getArrayLengthp (p) = (GC_arrayLength)bytes;
+  *getHeaderp (p) = GC_WORD8_VECTOR_HEADER;
+  b->buffer = pointerToObjptr (p, s->heap->start);
+  b->next = NULL;
+  b->isNew = TRUE;
+  unlockPinned ();
+  return (pointer)&b->buffer;
+}
+
+/* GC_pinnedFetched (slot)
+ *
+ * Called once the buffer whose objptr is in slot, as returned by
+ * GC_pinnedAlloc, is held by the SML side, so that it is only kept
+ * while it is reachable.
+ */
+void GC_pinnedFetched (pointer slot) {
+  GC_pinnedBlock b;
+
+  b = (GC_pinnedBlock)(slot - offsetof (struct GC_pinnedBlock, buffer));
+  b->isNew = FALSE;
+}
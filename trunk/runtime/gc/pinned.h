@@ -0,0 +1,72 @@
+/* Copyright (C) 1999-2008 Henry Cejtin, Matthew Fluet, Suresh
+ *    Jagannathan, and Stephen Weeks.
+ * Copyright (C) 1997-2000 NEC Research Institute.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* Pinned byte buffers.
+ *
+ * A pinned buffer is a Word8 array that the collector never moves, so
+ * that its address may be handed to the kernel and kept across
+ * collections.  Pinned buffers live in a region reserved outside the
+ * heap on the first allocation, pinned-size bytes long.  The
+ * collector treats an object pointer into the region as a leaf: it
+ * sets the mark bit in the buffer's header rather than forwarding or
+ * threading the pointer, and it never hash conses a buffer.
+ *
+ * The marks are cleared when a major GC, or a concurrent mark that a
+ * major GC will finish, starts, and only count until the sweep after
+ * that major GC, which frees every buffer that wasn't marked.  Minor
+ * GCs don't mark buffers, so a dropped buffer is freed by the first
+ * major GC that follows, except that one dropped while the concurrent
+ * marker runs may be kept until the next.  A buffer that has been
+ * allocated but not yet fetched by the SML side, and so may not be
+ * reachable from anything, is kept by its isNew flag instead.
+ *
+ * The region is a sequence of blocks, each a multiple of
+ * GC_PINNED_BLOCK_ALIGN bytes: a struct GC_pinnedBlock, then the array
+ * header, ending where the data starts, GC_PINNED_BLOCK_ALIGN bytes
+ * into the block.  Free blocks are kept on a list in address order,
+ * and adjacent free blocks are merged by the sweep.
+ */
+
+#define GC_PINNED_BLOCK_ALIGN 64
+
+typedef struct GC_pinnedBlock {
+  size_t size; /* of the whole block */
+  /* The buffer, or BOGUS_OBJPTR if the block is free.  The SML side
+   * fetches the buffer through this, and in the native model its
+   * value is also the address of the data.
+   */
+  objptr buffer;
+  struct GC_pinnedBlock *next; /* next free block, if free */
+  bool isNew; /* allocated, but not yet fetched */
+} *GC_pinnedBlock;
+
+COMPILE_TIME_ASSERT(GC_pinnedBlock__fits,
+                    sizeof(struct GC_pinnedBlock) + GC_ARRAY_HEADER_SIZE
+                    <= GC_PINNED_BLOCK_ALIGN);
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static inline bool isPointerPinned (pointer p);
+static inline bool isObjptrPinned (GC_state s, objptr op);
+static inline void markPinnedObjptr (GC_state s, objptr op);
+static bool hasPinnedBuffers (void);
+static void clearPinnedMarks (void);
+static void sweepPinned (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
+
+#if (defined (MLTON_GC_INTERNAL_BASIS))
+
+PRIVATE pointer GC_pinnedAlloc (GC_state *gs, size_t bytes);
+PRIVATE void GC_pinnedFetched (pointer slot);
+
+#endif /* (defined (MLTON_GC_INTERNAL_BASIS)) */
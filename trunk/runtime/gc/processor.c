@@ -2,16 +2,28 @@
 #include <pthread.h>
 
 int32_t Proc_processorNumber (GC_state s) {
-  for (int proc = 0; proc < s->numberOfProcs; proc ++) {
-    if (s == &(s->procStates[proc])) {
-      return (int32_t)proc;
-    }
+  assert (NULL == s->procStates or s == &s->procStates[s->procNumber]);
+  if (s->procNumber >= s->numberOfProcs) {
+    /* XXX shouldn't get here */
+    fprintf (stderr, "don't know my own processor number (signals?)\n");
+    exit (1);
   }
+  return s->procNumber;
+}
+
+/* The key is set once, when each thread starts, so the first lookup
+ * can be cached for good.
+ */
+static __thread GC_state Proc_currentState = NULL;
 
-  /* XXX shouldn't get here */
-  fprintf (stderr, "don't know my own processor number (signals?)\n");
-  exit (1);
-  return 0;
+GC_state Proc_getCurrentState (void) {
+  GC_state s = Proc_currentState;
+
+  if (NULL == s) {
+    s = pthread_getspecific (gcstate_key);
+    Proc_currentState = s;
+  }
+  return s;
 }
 
 bool Proc_amPrimary (GC_state s) {
@@ -63,6 +75,7 @@ void Proc_beginCriticalSection (GC_state s) {
       /* We are the first thread in this round. */
       if (needGCTime (s))
         startWallTiming (&tv_sync);
+      noteSyncStartForEventLog (s);
 
       switch (s->syncReason) {
       case SYNC_NONE:
@@ -97,13 +110,16 @@ void Proc_beginCriticalSection (GC_state s) {
         exit (1);
       }
 
-      //XXX KC signal every processor??
-      for (int i=0;i<s->numberOfProcs;i++)
-          Parallel_wakeUpThread (i, 0);
+      /* Only idle processors need a wake up; running ones will notice
+       * the rendezvous at their next allocation or safe point. */
+      Parallel_wakeParkedProcessors (s);
+      /* Processors parked in Parallel_lock must join as well. */
+      Parallel_wakeLockWaiters (s);
     }
 
     if (p == s->numberOfProcs) {
       /* We are the last to syncronize */
+      noteSyncEndForEventLog (s);
       if (needGCTime (s)) {
         stopWallTiming (&tv_sync, &s->cumulativeStatistics->tv_sync);
         startWallTiming (&tv_rt);
@@ -111,7 +127,10 @@ void Proc_beginCriticalSection (GC_state s) {
       Proc_criticalTicket = 0;
     }
 
-    while (Proc_criticalTicket != myNumber) {}
+    while (Proc_criticalTicket != myNumber) {
+      maybeHelpParallelCopy (s);
+      maybeHelpParallelShare (s);
+    }
   }
   else {
     Proc_criticalCount = 1;
@@ -133,7 +152,10 @@ void Proc_endCriticalSection (__attribute__ ((unused)) GC_state s) {
       __sync_synchronize ();
     }
 
-    while (Proc_criticalTicket >= 0) {}
+    while (Proc_criticalTicket >= 0) {
+      maybeHelpParallelCopy (s);
+      maybeHelpParallelShare (s);
+    }
   }
   else {
     Proc_criticalCount = 0;
@@ -143,3 +165,8 @@ void Proc_endCriticalSection (__attribute__ ((unused)) GC_state s) {
 bool Proc_threadInSection (__attribute__ ((unused)) GC_state s) {
   return Proc_criticalCount > 0;
 }
+
+bool Proc_isSynchronized (GC_state s) {
+  return Proc_isInitialized (s)
+    and Proc_criticalCount == s->numberOfProcs;
+}
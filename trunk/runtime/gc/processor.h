@@ -4,6 +4,8 @@
 
 /* Unique number for this thread */
 int32_t Proc_processorNumber (GC_state s);
+/* State of the processor running the calling thread */
+GC_state Proc_getCurrentState (void);
 /* Is the current processor the primary processor? */
 bool Proc_amPrimary (GC_state s);
 
@@ -16,5 +18,9 @@ bool Proc_isInitialized (GC_state s);
 void Proc_beginCriticalSection (GC_state s);
 void Proc_endCriticalSection (GC_state s);
 bool Proc_threadInSection (__attribute__ ((unused)) GC_state s);
+/* Are all processors inside the critical section (and so spinning
+ * whenever they are not the one running)?
+ */
+bool Proc_isSynchronized (GC_state s);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -200,12 +200,20 @@ void incForProfiling (GC_state s, size_t amount, GC_sourceSeqIndex sourceSeqInde
     leaveForProfiling (s, sourceSeqIndex);
 }
 
+/* The processor doing a collection and those helping it with a
+ * parallel round are charged for it; the others are charged for
+ * wherever they stopped to wait.
+ */
+static inline bool isInGCForProfiling (GC_state s) {
+  return s->amInGC or s->amHelpingGC;
+}
+
 void GC_profileInc (GC_state s, size_t amount) {
   if (DEBUG_PROFILE)
     fprintf (stderr, "GC_profileInc (%"PRIuMAX") [%d]\n", (uintmax_t)amount,
              Proc_processorNumber (s));
   incForProfiling (s, amount,
-                   s->amInGC
+                   isInGCForProfiling (s)
                    ? SOURCE_SEQ_GC
                    : getCachedStackTopFrameSourceSeqIndex (s));
 }
@@ -219,6 +227,52 @@ void GC_profileAllocInc (GC_state s, size_t amount) {
   }
 }
 
+/* Add the samples in s's ring to s's profile data.  Unless wait, give
+ * up if someone else is already doing so.
+ */
+void flushProfileSamples (GC_state s, bool wait) {
+  struct GC_profileSamples *r;
+  uint32_t head, tail;
+
+  r = &s->profiling.samples;
+  if (NULL == r->ring)
+    return;
+  while (__sync_lock_test_and_set (&r->isFlushing, 1)) {
+    unless (wait)
+      return;
+    while (r->isFlushing) { }
+  }
+  head = r->head;
+  __sync_synchronize ();
+  for (tail = r->tail; tail != head; tail++)
+    incForProfiling (s, 1, r->ring[tail % GC_PROFILE_SAMPLES_LENGTH]);
+  r->tail = tail;
+  __sync_lock_release (&r->isFlushing);
+}
+
+/* Called by the SIGPROF handler. */
+static void addProfileSample (GC_state s, GC_sourceSeqIndex sourceSeqIndex) {
+  struct GC_profileSamples *r;
+  uint32_t head;
+
+  if (s->profiling.stack) {
+    incForProfiling (s, 1, sourceSeqIndex);
+    return;
+  }
+  r = &s->profiling.samples;
+  head = r->head;
+  if (head - r->tail >= GC_PROFILE_SAMPLES_LENGTH / 2)
+    flushProfileSamples (s, FALSE);
+  if (head - r->tail == GC_PROFILE_SAMPLES_LENGTH) {
+    /* Someone else is flushing, and has been for a while. */
+    r->numLost++;
+    return;
+  }
+  r->ring[head % GC_PROFILE_SAMPLES_LENGTH] = sourceSeqIndex;
+  __sync_synchronize ();
+  r->head = head + 1;
+}
+
 GC_profileData profileMalloc (GC_state s) {
   GC_profileData p;
   uint32_t profileMasterLength;
@@ -251,6 +305,21 @@ void profileFree (GC_state s, GC_profileData p) {
   free (p);
 }
 
+void addProfileData (GC_state s, GC_profileData to, GC_profileData from) {
+  uint32_t profileMasterLength;
+
+  to->total += from->total;
+  to->totalGC += from->totalGC;
+  profileMasterLength = s->sourceMaps.sourcesLength + s->sourceMaps.sourceNamesLength;
+  for (uint32_t i = 0; i < profileMasterLength; i++) {
+    to->countTop[i] += from->countTop[i];
+    if (s->profiling.stack) {
+      to->stack[i].ticks += from->stack[i].ticks;
+      to->stack[i].ticksGC += from->stack[i].ticksGC;
+    }
+  }
+}
+
 void GC_profileFree (__attribute__ ((unused)) GC_state *gs, GC_profileData p) {
   GC_state s = pthread_getspecific (gcstate_key);
   profileFree (s, p);
@@ -320,14 +389,39 @@ void profileWrite (GC_state s, GC_profileData p, const char *fileName) {
   fclose_safe (f);
 }
 
+/* Writing the current data writes the sum of every processor's current
+ * data, since each processor has its own.
+ */
 void GC_profileWrite (__attribute__ ((unused)) GC_state *gs, GC_profileData p, NullString8_t fileName) {
   GC_state s = pthread_getspecific (gcstate_key);
-  profileWrite (s, p, (const char*)fileName);
+
+  if (p == s->profiling.data
+      and NULL != s->procStates
+      and s->numberOfProcs > 1) {
+    GC_profileData merged;
+
+    merged = profileMalloc (s);
+    for (int proc = 0; proc < s->numberOfProcs; proc++) {
+      GC_state ps = &s->procStates[proc];
+
+      if (NULL == ps->profiling.data)
+        continue;
+      flushProfileSamples (ps, TRUE);
+      addProfileData (s, merged, ps->profiling.data);
+    }
+    profileWrite (s, merged, (const char*)fileName);
+    profileFree (s, merged);
+  } else {
+    flushProfileSamples (s, TRUE);
+    profileWrite (s, p, (const char*)fileName);
+  }
 }
 
 void setProfTimer (long usec) {
   struct itimerval iv;
 
+  if (GC_setThreadProfTimer (usec))
+    return;
   iv.it_interval.tv_sec = 0;
   iv.it_interval.tv_usec = usec;
   iv.it_value.tv_sec = 0;
@@ -336,6 +430,15 @@ void setProfTimer (long usec) {
     die ("setProfTimer: setitimer failed");
 }
 
+static void initProfileSamples (GC_state s) {
+  s->profiling.samples.ring = (GC_sourceSeqIndex *)
+    calloc_safe (GC_PROFILE_SAMPLES_LENGTH, sizeof (GC_sourceSeqIndex));
+  s->profiling.samples.head = 0;
+  s->profiling.samples.tail = 0;
+  s->profiling.samples.isFlushing = 0;
+  s->profiling.samples.numLost = 0;
+}
+
 #if not HAS_TIME_PROFILING
 
 /* No time profiling on this platform.  There is a check in
@@ -358,21 +461,16 @@ void GC_handleSigProf (code_pointer pc) {
   GC_sourceSeqIndex sourceSeqsIndex;
 
   s = pthread_getspecific (gcstate_key);
+  /* A thread's timer may go off before it has a state, or after
+   * GC_profileDone.
+   */
+  if (NULL == s or not s->profiling.isOn)
+    return;
   if (DEBUG_PROFILE)
     fprintf (stderr, "GC_handleSigProf ("FMTPTR") [%d]\n", (uintptr_t)pc,
              Proc_processorNumber (s));
 
-  bool isSomeProcInGC = false;
-
-  /* XXX KC race condition between checking the amInGC flag and setting it on another processor */
-  for (int proc = 0; proc < s->numberOfProcs; proc ++) {
-      if ((s->procStates[proc]).amInGC == TRUE) {
-          isSomeProcInGC = true;
-          break;
-      }
-  }
-
-  if (isSomeProcInGC)
+  if (isInGCForProfiling (s))
     sourceSeqsIndex = SOURCE_SEQ_GC;
   else {
     frameIndex = getCachedStackTopFrameIndex (s);
@@ -411,7 +509,7 @@ void GC_handleSigProf (code_pointer pc) {
       }
     }
   }
-  incForProfiling (s, 1, sourceSeqsIndex);
+  addProfileSample (s, sourceSeqsIndex);
 }
 
 void GC_profileDisable (void) {
@@ -425,9 +523,11 @@ void GC_profileEnable (void) {
 void turnOnProfilingTime (GC_state s) {
   assert (s);
   /*
-   * Install catcher, which handles SIGUSR1 and calls MLton_Profile_inc.
-   * SIGPROF is handled by the signal handler thread (c-main.h) and broadcast
-   * as SIGUSR1 to every thread.
+   * Install catcher, which handles SIGPROF and calls GC_handleSigProf.
+   * Where the platform has them, each processor thread has its own
+   * CPU-time timer that sends it SIGPROF.  Otherwise, SIGPROF is handled
+   * by the signal handler thread (c-main.h) and broadcast as SIGUSR1 to
+   * every thread, so catcher handles SIGUSR1 instead.
    *
    * One thing I should point out that I discovered the hard way: If the call
    * to sigaction does NOT specify the SA_ONSTACK flag, then even if you have
@@ -441,8 +541,12 @@ void turnOnProfilingTime (GC_state s) {
   struct sigaction sa;
   sigemptyset (&sa.sa_mask);
   GC_setSigProfHandler (&sa);
-  unless (sigaction (SIGUSR1, &sa, NULL) == 0)
+  s->profiling.hasThreadTimer = GC_createThreadProfTimer ();
+  unless (sigaction (s->profiling.hasThreadTimer ? SIGPROF : SIGUSR1,
+                     &sa, NULL) == 0)
     diee ("turnOnProfilingTime: sigaction failed");
+  if (s->profiling.hasThreadTimer)
+    GC_setThreadProfTimer (10000);
 
   s->profiling.isProfilingTimeOn = TRUE;
 }
@@ -450,6 +554,7 @@ void turnOnProfilingTime (GC_state s) {
 
 static void initProfilingTime (GC_state s) {
   s->profiling.data = profileMalloc (s);
+  initProfileSamples (s);
   if (PROFILE_TIME_LABEL == s->profiling.kind) {
     initSourceLabels (s);
   } else {
@@ -479,6 +584,7 @@ void atexitForProfiling (void) {
   if (s->profiling.isOn && s->profiling.data) {
     fprintf (stderr, "profiling is on[%d]\n", Proc_processorNumber(s));
     sprintf(fname, "mlmon.%d.out", Proc_processorNumber (s));
+    flushProfileSamples (s, TRUE);
     profileWrite (s, s->profiling.data, fname);
   }
 }
@@ -511,6 +617,38 @@ void initProfiling (GC_state s) {
   }
 }
 
+/* Each processor gets its own data and ring of samples.  The source
+ * maps are shared, and were already set up by initProfiling on the
+ * first processor.
+ */
+static void duplicateProfiling (GC_state d, GC_state s) {
+  d->profiling.isOn = s->profiling.isOn;
+  d->profiling.data = NULL;
+  d->profiling.samples.ring = NULL;
+  unless (s->profiling.isOn)
+    return;
+  d->profiling.data = profileMalloc (d);
+  if (PROFILE_TIME_FIELD == s->profiling.kind
+      or PROFILE_TIME_LABEL == s->profiling.kind) {
+    initProfileSamples (d);
+    d->sourceMaps.curSourceSeqsIndex = SOURCE_SEQ_UNKNOWN;
+  }
+}
+
+/* Called by each processor thread as it starts.  The timers are per
+ * thread, and initProfiling only made the main thread's.
+ */
+void GC_startProfilingTime (GC_state s) {
+  unless (s->profiling.isOn
+          and s->profiling.hasThreadTimer
+          and not s->profiling.isProfilingTimeOn)
+    return;
+  unless (GC_createThreadProfTimer ())
+    diee ("GC_startProfilingTime: timer_create failed");
+  GC_setThreadProfTimer (10000);
+  s->profiling.isProfilingTimeOn = TRUE;
+}
+
 void GC_profileDone (__attribute__ ((unused)) GC_state *gs) {
   GC_profileData p;
   GC_profileMasterIndex profileMasterIndex;
@@ -526,6 +664,10 @@ void GC_profileDone (__attribute__ ((unused)) GC_state *gs) {
         or PROFILE_TIME_LABEL == s->profiling.kind)
         setProfTimer (0);
     s->profiling.isOn = FALSE;
+    flushProfileSamples (s, TRUE);
+    if (DEBUG_PROFILE and s->profiling.samples.numLost > 0)
+      fprintf (stderr, "lost %"PRIuMAX" profiling ticks [%d]\n",
+               s->profiling.samples.numLost, Proc_processorNumber (s));
     p = s->profiling.data;
     if (s->profiling.stack) {
         uint32_t profileMasterLength =
@@ -556,6 +698,8 @@ GC_profileData GC_getProfileCurrent (__attribute__ ((unused)) GC_state *gs) {
 }
 void GC_setProfileCurrent (__attribute__ ((unused)) GC_state *gs, GC_profileData p) {
   GC_state s = pthread_getspecific (gcstate_key);
+  /* The ticks so far belong to the old data. */
+  flushProfileSamples (s, TRUE);
   s->profiling.data = p;
 }
 
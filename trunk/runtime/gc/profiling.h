@@ -64,12 +64,34 @@ typedef struct GC_profileData {
   uintmax_t totalGC;
 } *GC_profileData;
 
+/* With time profiling (other than of the stack, which has to be
+ * charged while the stack is as it was), the SIGPROF handler doesn't
+ * touch the profile data.  It just records the source of the tick in
+ * its processor's ring of samples.  The samples are added to the data
+ * in batches, by whoever holds isFlushing: the handler itself, once the
+ * ring is half full, or anyone about to write or switch the data.
+ */
+#define GC_PROFILE_SAMPLES_LENGTH 1024
+
+struct GC_profileSamples {
+  GC_sourceSeqIndex *ring;
+  volatile uint32_t head; /* only written by the SIGPROF handler */
+  volatile uint32_t tail; /* only written by whoever holds isFlushing */
+  volatile int32_t isFlushing;
+  uintmax_t numLost; /* ticks dropped because the ring was full */
+};
+
 struct GC_profiling {
   GC_profileData data;
   bool isOn;
   bool isProfilingTimeOn;
+  /* SIGPROF comes from a CPU-time timer for this processor's thread,
+   * rather than being passed on as SIGUSR1 by runProfHandler.
+   */
+  bool hasThreadTimer;
   GC_profileKind kind;
   bool stack;
+  struct GC_profileSamples samples;
 };
 
 #else
@@ -99,6 +121,9 @@ static inline void incForProfiling (GC_state s, size_t amount, GC_sourceSeqIndex
 
 static inline char* profileIndexSourceName (GC_state s, GC_sourceIndex i);
 
+static void flushProfileSamples (GC_state s, bool wait);
+static void addProfileData (GC_state s, GC_profileData to, GC_profileData from);
+
 static void writeProfileCount (GC_state s, FILE *f, GC_profileData p, GC_profileMasterIndex i);
 
 PRIVATE GC_profileData profileMalloc (GC_state s);
@@ -106,9 +131,11 @@ PRIVATE void profileWrite (GC_state s, GC_profileData p, const char* fileName);
 PRIVATE void profileFree (GC_state s, GC_profileData p);
 
 static void setProfTimer (long usec);
+static void initProfileSamples (GC_state s);
 static void initProfilingTime (GC_state s);
 static void atexitForProfiling (void);
 static void initProfiling (GC_state s);
+static void duplicateProfiling (GC_state d, GC_state s);
 
 void turnOnProfilingTime (GC_state s);
 
@@ -132,6 +159,7 @@ void GC_profileDisable (void);
 void GC_profileEnable (void);
 
 PRIVATE void GC_profileDone (GC_state *gs);
+PRIVATE void GC_startProfilingTime (GC_state s);
 
 #endif /* (defined (MLTON_GC_INTERNAL_BASIS)) */
 
@@ -14,18 +14,29 @@ void GC_share (GC_state s, pointer object) {
   //enter (s); /* update stack in heap, in case it is reached */
   s->syncReason = SYNC_FORCE;
   ENTER0 (s); /* update stack in heap, in case it is reached */
+  /* The mark bits are ours now. */
+  abortConcurrentMark (s);
 
   if (DEBUG_SHARE)
     fprintf (stderr, "GC_share "FMTPTR" [%d]\n", (uintptr_t)object,
              Proc_processorNumber (s));
   if (DEBUG_SHARE or s->controls->messages)
     s->lastMajorStatistics->bytesHashConsed = 0;
-  // Don't hash cons during the first round of marking.
-  bytesExamined = dfsMarkByMode (s, object, MARK_MODE, FALSE, FALSE);
-  s->objectHashTable = allocHashTable (s);
-  // Hash cons during the second round of (un)marking.
-  dfsMarkByMode (s, object, UNMARK_MODE, TRUE, FALSE);
-  freeHashTable (s->objectHashTable);
+  if (shouldShareInParallel (s)) {
+    objptr op;
+
+    op = pointerToObjptr (object, s->heap->start);
+    beginParallelShare (s);
+    addParallelShareRoot (s, &op);
+    bytesExamined = shareInParallel (s, FALSE);
+  } else {
+    // Don't hash cons during the first round of marking.
+    bytesExamined = dfsMarkByMode (s, object, MARK_MODE, FALSE, FALSE);
+    s->objectHashTable = allocHashTable (s);
+    // Hash cons during the second round of (un)marking.
+    dfsMarkByMode (s, object, UNMARK_MODE, TRUE, FALSE);
+    freeHashTable (s->objectHashTable);
+  }
   bytesHashConsed = s->lastMajorStatistics->bytesHashConsed;
   s->cumulativeStatistics->bytesHashConsed += bytesHashConsed;
   if (DEBUG_SHARE or s->controls->messages)
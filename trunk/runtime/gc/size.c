@@ -13,6 +13,8 @@ size_t GC_size (GC_state s, pointer root) {
   //enter (s); /* update stack in heap, in case it is reached */
   s->syncReason = SYNC_FORCE;
   ENTER0 (s); /* update stack in heap, in case it is reached */
+  /* The mark bits are ours now. */
+  abortConcurrentMark (s);
 
   if (DEBUG_SIZE)
     fprintf (stderr, "GC_size marking\n");
@@ -5,3 +5,50 @@
  * MLton is released under a BSD-style license.
  * See the file MLton-LICENSE for details.
  */
+
+void initProcessorStatistics (GC_state s) {
+  s->procStatistics.bytesAllocated = 0;
+  s->procStatistics.maxStackSize = 0;
+}
+
+/* The alarm handler thread has a state of its own, after the
+ * processors' states.
+ */
+static inline int32_t numberOfStatisticsStates (GC_state s) {
+  return (NULL == s->procStates) ? 0 : s->numberOfProcs + 1;
+}
+
+static void mergeOneProcessorStatistics (GC_state s, GC_state p) {
+  s->cumulativeStatistics->bytesAllocated += p->procStatistics.bytesAllocated;
+  s->cumulativeStatistics->maxStackSize =
+    max (s->cumulativeStatistics->maxStackSize,
+         p->procStatistics.maxStackSize);
+  initProcessorStatistics (p);
+}
+
+/* Must be called with the world stopped. */
+void mergeProcessorStatistics (GC_state s) {
+  int32_t n;
+
+  n = numberOfStatisticsStates (s);
+  if (0 == n)
+    mergeOneProcessorStatistics (s, s);
+  for (int32_t proc = 0; proc < n; proc++)
+    mergeOneProcessorStatistics (s, &s->procStates[proc]);
+}
+
+/* May be called while the other processors are running, so it doesn't
+ * merge; the result may miss their most recent allocations.
+ */
+uintmax_t getBytesAllocated (GC_state s) {
+  uintmax_t bytes;
+  int32_t n;
+
+  bytes = s->cumulativeStatistics->bytesAllocated;
+  n = numberOfStatisticsStates (s);
+  if (0 == n)
+    bytes += s->procStatistics.bytesAllocated;
+  for (int32_t proc = 0; proc < n; proc++)
+    bytes += s->procStates[proc].procStatistics.bytesAllocated;
+  return bytes;
+}
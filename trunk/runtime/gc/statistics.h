@@ -40,6 +40,8 @@ struct GC_cumulativeStatistics {
   uintmax_t numHashConsGCs;
   uintmax_t numMarkCompactGCs;
   uintmax_t numMinorGCs;
+  uintmax_t numParallelGCs; /* Copying GCs done by all processors. */
+  uintmax_t numConcurrentMarks; /* Marks started in the background. */
 
   struct timeval ru_gc; /* total resource usage in gc. */
   struct rusage ru_gcCopying; /* resource usage in major copying gcs. */
@@ -63,6 +65,16 @@ struct GC_cumulativeStatistics {
 
 };
 
+/* Statistics updated on the allocation path.  Each processor keeps
+ * its own, in its GC_state, and they are merged into the cumulative
+ * statistics whenever the world is stopped for a GC and before the
+ * summary is printed.
+ */
+struct GC_processorStatistics {
+  uintmax_t bytesAllocated;
+  size_t maxStackSize;
+};
+
 struct GC_lastMajorStatistics {
   size_t bytesHashConsed;
   size_t bytesLive; /* Number of bytes live at most recent major GC. */
@@ -71,3 +83,12 @@ struct GC_lastMajorStatistics {
 };
 
 #endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static inline void initProcessorStatistics (GC_state s);
+static inline int32_t numberOfStatisticsStates (GC_state s);
+static void mergeProcessorStatistics (GC_state s);
+static uintmax_t getBytesAllocated (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
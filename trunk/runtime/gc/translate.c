@@ -41,8 +41,9 @@ void translateHeap (GC_state s, pointer from, pointer to, size_t size) {
              (uintptr_t)from);
   translateState.from = from;
   translateState.to = to;
-  /* Translate globals and heap. */
+  /* Translate globals, sampled objects, and heap. */
   foreachGlobalObjptr (s, translateObjptr);
+  foreachHeapProfileObjptr (s, translateObjptr);
   limit = to + size;
   foreachObjptrInRange (s, alignFrontier (s, to), &limit, translateObjptr, FALSE);
 }
@@ -6,9 +6,246 @@
  * See the file MLton-LICENSE for details.
  */
 
+/* Set once part of the heap is a copy-on-write mapping of a world
+ * file, which is then identified by worldDev and worldIno.
+ */
+static bool worldIsMapped = FALSE;
+static dev_t worldDev;
+static ino_t worldIno;
+
+/* Maps the heap in the world file f, at heapOffset, over the old
+ * generation.  Pages are then read in as they are touched, and only
+ * copied when written.
+ */
+static bool mapWorldHeap (GC_state s, FILE *f, size_t heapOffset) {
+  struct stat st;
+  size_t length;
+  int fd;
+
+  length = align (s->heap->oldGenSize, s->sysvals.pageSize);
+  if (0 == length or not isAligned (heapOffset, s->sysvals.pageSize))
+    return FALSE;
+  fd = fileno (f);
+  if (fd < 0
+      or fstat (fd, &st) != 0
+      or (void*)-1 == GC_mapFile (s->heap->start, length, fd, heapOffset))
+    return FALSE;
+  /* The end of the last page holds the start of the globals. */
+  memset (s->heap->start + s->heap->oldGenSize, 0,
+          length - s->heap->oldGenSize);
+  worldIsMapped = TRUE;
+  worldDev = st.st_dev;
+  worldIno = st.st_ino;
+  if (DEBUG_WORLD or s->controls->messages)
+    fprintf (stderr,
+             "[GC: Mapped world heap of size %s bytes at "FMTPTR".]\n",
+             uintmaxToCommaString (s->heap->oldGenSize),
+             (uintptr_t)(s->heap->start));
+  return TRUE;
+}
+
+static void *runWorldChunkWorker (void *arg) {
+  struct GC_worldChunkBatch *batch;
+  size_t i;
+
+  batch = (struct GC_worldChunkBatch *)arg;
+  while ((i = __sync_fetch_and_add (&batch->next, 1)) < batch->numChunks)
+    batch->work (&batch->chunks[i]);
+  return NULL;
+}
+
+static inline int32_t numberOfWorldWorkers (GC_state s) {
+  return max (1, min (s->numberOfProcs, GC_WORLD_MAX_WORKERS));
+}
+
+static inline size_t lengthOfWorldBatch (int32_t numWorkers, size_t chunkSize) {
+  return max ((size_t)1,
+              min (2 * (size_t)numWorkers, GC_WORLD_BATCH_SIZE / chunkSize));
+}
+
+/* Runs batch->work on each chunk, using up to numWorkers threads,
+ * including this one.  If threads can't be started, this one does the
+ * rest.
+ */
+static void forEachWorldChunk (struct GC_worldChunkBatch *batch,
+                               int32_t numWorkers) {
+  pthread_t threads[GC_WORLD_MAX_WORKERS];
+  int32_t numStarted;
+
+  batch->next = 0;
+  numWorkers = min ((size_t)numWorkers, batch->numChunks);
+  for (numStarted = 0; numStarted < numWorkers - 1; numStarted++)
+    if (pthread_create (&threads[numStarted], NULL,
+                        runWorldChunkWorker, (void*)batch))
+      break;
+  runWorldChunkWorker ((void*)batch);
+  for (int32_t i = 0; i < numStarted; i++)
+    pthread_join (threads[i], NULL);
+}
+
+static void compressWorldChunk (struct GC_worldChunk *chunk) {
+  chunk->checksum = computeAdler32 (chunk->raw, chunk->rawSize);
+  /* Only keep the compressed chunk if it is smaller, so that its
+   * stored size tells the two apart.
+   */
+  chunk->storedSize =
+    lzCompress (chunk->raw, chunk->rawSize, chunk->stored, chunk->rawSize - 1);
+  if (0 == chunk->storedSize) {
+    chunk->stored = chunk->raw;
+    chunk->storedSize = chunk->rawSize;
+  }
+}
+
+static void decompressWorldChunk (struct GC_worldChunk *chunk) {
+  if (chunk->storedSize == chunk->rawSize and chunk->stored != chunk->raw)
+    memcpy (chunk->raw, chunk->stored, chunk->rawSize);
+  chunk->ok =
+    (chunk->storedSize == chunk->rawSize
+     or lzDecompress (chunk->stored, chunk->storedSize,
+                      chunk->raw, chunk->rawSize))
+    and chunk->checksum == computeAdler32 (chunk->raw, chunk->rawSize);
+}
+
+/* Compresses the old generation in batches of chunks, writing each
+ * batch as soon as it is done.
+ */
+static int saveWorldHeapCompressed (GC_state s, FILE *f) {
+  struct GC_worldChunkBatch batch;
+  struct GC_worldChunk *chunks;
+  uint8_t *buffers;
+  size_t batchLength;
+  size_t chunkSize;
+  size_t offset;
+  int32_t numWorkers;
+  int res;
+
+  res = -1;
+  chunkSize = GC_WORLD_CHUNK_SIZE;
+  numWorkers = numberOfWorldWorkers (s);
+  batchLength = lengthOfWorldBatch (numWorkers, chunkSize);
+  chunks = (struct GC_worldChunk *)
+    malloc (batchLength * sizeof (struct GC_worldChunk));
+  buffers = (uint8_t *) malloc (batchLength * chunkSize);
+  if (NULL == chunks or NULL == buffers)
+    goto done;
+  if (fwrite (&chunkSize, sizeof(size_t), 1, f) != 1) goto done;
+  batch.chunks = chunks;
+  batch.work = compressWorldChunk;
+  for (offset = 0; offset < s->heap->oldGenSize; ) {
+    batch.numChunks = 0;
+    while (batch.numChunks < batchLength and offset < s->heap->oldGenSize) {
+      struct GC_worldChunk *chunk = &chunks[batch.numChunks];
+
+      chunk->raw = s->heap->start + offset;
+      chunk->rawSize = min (chunkSize, s->heap->oldGenSize - offset);
+      chunk->stored = buffers + batch.numChunks * chunkSize;
+      offset += chunk->rawSize;
+      batch.numChunks++;
+    }
+    forEachWorldChunk (&batch, numWorkers);
+    for (size_t i = 0; i < batch.numChunks; i++) {
+      uint32_t storedSize = (uint32_t)chunks[i].storedSize;
+
+      if (fwrite (&storedSize, sizeof(uint32_t), 1, f) != 1) goto done;
+      if (fwrite (&chunks[i].checksum, sizeof(uint32_t), 1, f) != 1) goto done;
+      if (fwrite (chunks[i].stored, 1, storedSize, f) != storedSize) goto done;
+    }
+  }
+  res = 0;
+done:
+  free (chunks);
+  free (buffers);
+  return res;
+}
+
+/* Reads the chunks of the old generation in batches, decompressing
+ * and checking each batch in parallel.
+ */
+static void loadWorldHeapCompressed (GC_state s, FILE *f) {
+  struct GC_worldChunkBatch batch;
+  struct GC_worldChunk *chunks;
+  uint8_t *buffers;
+  size_t batchLength;
+  size_t chunkSize;
+  size_t offset;
+  int32_t numWorkers;
+
+  chunkSize = readSize (f);
+  unless (0 < chunkSize and chunkSize <= GC_WORLD_BATCH_SIZE)
+    die ("Invalid world: bad chunk size.");
+  numWorkers = numberOfWorldWorkers (s);
+  batchLength = lengthOfWorldBatch (numWorkers, chunkSize);
+  chunks = (struct GC_worldChunk *)
+    malloc_safe (batchLength * sizeof (struct GC_worldChunk));
+  buffers = (uint8_t *) malloc_safe (batchLength * chunkSize);
+  batch.chunks = chunks;
+  batch.work = decompressWorldChunk;
+  for (offset = 0; offset < s->heap->oldGenSize; ) {
+    batch.numChunks = 0;
+    while (batch.numChunks < batchLength and offset < s->heap->oldGenSize) {
+      struct GC_worldChunk *chunk = &chunks[batch.numChunks];
+
+      chunk->raw = s->heap->start + offset;
+      chunk->rawSize = min (chunkSize, s->heap->oldGenSize - offset);
+      chunk->storedSize = readUint32 (f);
+      chunk->checksum = readUint32 (f);
+      if (chunk->storedSize > chunk->rawSize)
+        die ("Invalid world: bad chunk at offset %s.",
+             uintmaxToCommaString (offset));
+      /* A chunk that isn't compressed can go straight to the heap. */
+      chunk->stored = (chunk->storedSize == chunk->rawSize)
+        ? chunk->raw
+        : buffers + batch.numChunks * chunkSize;
+      fread_safe (chunk->stored, 1, chunk->storedSize, f);
+      offset += chunk->rawSize;
+      batch.numChunks++;
+    }
+    forEachWorldChunk (&batch, numWorkers);
+    for (size_t i = 0; i < batch.numChunks; i++)
+      unless (chunks[i].ok)
+        die ("Invalid world: corrupt chunk at offset %s.",
+             uintmaxToCommaString ((size_t)(chunks[i].raw - s->heap->start)));
+  }
+  free (chunks);
+  free (buffers);
+}
+
+/* Computes the checksum of all of f but the heap, from heapStart to
+ * heapEnd, by reading it back, since the globals are written straight
+ * to f by saveGlobals.
+ */
+bool checksumWorldFile (FILE *f, long heapStart, long heapEnd,
+                        long end, uint32_t *checksum) {
+  uint8_t buf[4096];
+  long ranges[2][2] = { { 0, heapStart }, { heapEnd, end } };
+  uint32_t adler;
+
+  adler = 1;
+  for (int i = 0; i < 2; i++) {
+    long pos = ranges[i][0];
+
+    if (fseek (f, pos, SEEK_SET) != 0) return FALSE;
+    while (pos < ranges[i][1]) {
+      size_t n = min (sizeof(buf), (size_t)(ranges[i][1] - pos));
+
+      if (fread (buf, 1, n, f) != n) return FALSE;
+      adler = updateAdler32 (adler, buf, n);
+      pos += (long)n;
+    }
+  }
+  *checksum = adler;
+  return TRUE;
+}
+
 void loadWorldFromFILE (GC_state s, FILE *f) {
   uint32_t magic;
   pointer start;
+  uint32_t heapFormat;
+  size_t heapOffset;
+  long fileSize;
+  long heapStart, heapEnd, end;
+  uint32_t checksum;
+  size_t crossMapLength;
 
   if (DEBUG_WORLD)
     fprintf (stderr, "loadWorldFromFILE\n");
@@ -22,12 +259,55 @@ void loadWorldFromFILE (GC_state s, FILE *f) {
   s->callFromCHandlerThread = readObjptr (f);
   s->currentThread = readObjptr (f);
   s->signalHandlerThread = readObjptr (f);
-  createHeap (s, s->heap,
-              sizeofHeapDesired (s, s->heap->oldGenSize, 0),
-              s->heap->oldGenSize);
+  heapFormat = readUint32 (f);
+  heapOffset = 0;
+  if (GC_WORLD_HEAP_MAPPED == heapFormat) {
+    heapOffset = readSize (f);
+    heapStart = (long)heapOffset;
+    fseek_safe (f, 0, SEEK_END);
+    fileSize = ftell (f);
+    if (fileSize < 0 or (size_t)fileSize < heapOffset + s->heap->oldGenSize)
+      die ("Invalid world: truncated heap.");
+  } else if (GC_WORLD_HEAP_COMPRESSED == heapFormat)
+    heapStart = ftell (f);
+  else
+    die ("Invalid world: unknown heap format.");
+  /* With the heap where it was saved, there is nothing to translate. */
+  unless (createHeapAt (s, s->heap, start,
+                        sizeofHeapDesired (s, s->heap->oldGenSize, 0),
+                        s->heap->oldGenSize))
+    createHeap (s, s->heap,
+                sizeofHeapDesired (s, s->heap->oldGenSize, 0),
+                s->heap->oldGenSize);
   setCardMapAndCrossMap (s);
-  fread_safe (s->heap->start, 1, s->heap->oldGenSize, f);
+  if (GC_WORLD_HEAP_COMPRESSED == heapFormat)
+    loadWorldHeapCompressed (s, f);
+  else {
+    unless (mapWorldHeap (s, f, heapOffset)) {
+      fseek_safe (f, (long)heapOffset, SEEK_SET);
+      fread_safe (s->heap->start, 1, s->heap->oldGenSize, f);
+    }
+    fseek_safe (f, (long)(heapOffset + s->heap->oldGenSize), SEEK_SET);
+  }
+  heapEnd = ftell (f);
+  /* Reading the cross map saves the first minor GC from walking, and
+   * so paging in, the whole old generation.
+   */
+  crossMapLength = readSize (f);
+  if (0 < crossMapLength
+      and crossMapLength <= s->generationalMaps.crossMapLength) {
+    fread_safe (s->generationalMaps.crossMap,
+                CROSS_MAP_ELEM_SIZE, crossMapLength, f);
+    s->generationalMaps.crossMapValidSize = s->heap->oldGenSize;
+  } else
+    fseek_safe (f, (long)(crossMapLength * CROSS_MAP_ELEM_SIZE), SEEK_CUR);
   if ((*(s->loadGlobals)) (f) != 0) diee("couldn't load globals");
+  end = ftell (f);
+  if (heapStart < 0 or heapEnd < 0 or end < 0)
+    diee ("couldn't checksum world");
+  unless (checksumWorldFile (f, heapStart, heapEnd, end, &checksum)
+          and checksum == readUint32 (f))
+    die ("Invalid world: bad checksum.");
   // unless (EOF == fgetc (file))
   //  die ("Invalid world: junk at end of file.");
   /* translateHeap must occur after loading the heap and globals,
@@ -54,11 +334,19 @@ void loadWorldFromFileName (GC_state s, const char *fileName) {
 int saveWorldToFILE (GC_state s, FILE *f) {
   char buf[128];
   size_t len;
+  long pos;
+  uint32_t heapFormat;
+  size_t heapOffset;
+  long heapStart, heapEnd, end;
+  uint32_t checksum;
+  size_t crossMapLength;
 
   if (DEBUG_WORLD)
     fprintf (stderr, "saveWorldToFILE\n");
   /* Compact the heap. */
   performGC (s, 0, 0, TRUE, TRUE);
+  if (hasPinnedBuffers ())
+    die ("Cannot save world with pinned buffers.");
   snprintf (buf, cardof(buf),
             "Heap file created by MLton.\nheap->start = "FMTPTR"\nbytesLive = %"PRIuMAX"\n",
             (uintptr_t)s->heap->start,
@@ -79,19 +367,75 @@ int saveWorldToFILE (GC_state s, FILE *f) {
   if (fwrite (&s->currentThread, sizeof(objptr), 1, f) != 1) return -1;
   if (fwrite (&s->signalHandlerThread, sizeof(objptr), 1, f) != 1) return -1;
 
-  if (fwrite (s->heap->start, 1, s->heap->oldGenSize, f) != s->heap->oldGenSize)
+  heapFormat = s->controls->compressWorld
+    ? GC_WORLD_HEAP_COMPRESSED
+    : GC_WORLD_HEAP_MAPPED;
+  if (fwrite (&heapFormat, sizeof(uint32_t), 1, f) != 1) return -1;
+  if (GC_WORLD_HEAP_COMPRESSED == heapFormat) {
+    heapStart = ftell (f);
+    if (heapStart < 0) return -1;
+    if (saveWorldHeapCompressed (s, f) != 0)
+      return -1;
+  } else {
+    /* Pad so that the heap can be mapped in by loadWorldFromFILE. */
+    pos = ftell (f);
+    if (pos < 0) return -1;
+    pos += sizeof(size_t);
+    heapOffset = align ((size_t)pos, GC_WORLD_HEAP_ALIGN);
+    if (fwrite (&heapOffset, sizeof(size_t), 1, f) != 1) return -1;
+    for (; (size_t)pos < heapOffset; pos++)
+      if (fputc ('\000', f) == EOF) return -1;
+    heapStart = (long)heapOffset;
+    if (fwrite (s->heap->start, 1, s->heap->oldGenSize, f) != s->heap->oldGenSize)
+      return -1;
+  }
+  heapEnd = ftell (f);
+  if (heapEnd < 0) return -1;
+  if (s->mutatorMarksCards and s->heap->oldGenSize > 0) {
+    updateCrossMap (s);
+    crossMapLength =
+      min (sizeToCardMapIndex (s->heap->oldGenSize) + 1,
+           s->generationalMaps.crossMapLength);
+  } else
+    crossMapLength = 0;
+  if (fwrite (&crossMapLength, sizeof(size_t), 1, f) != 1) return -1;
+  if (crossMapLength > 0
+      and fwrite (s->generationalMaps.crossMap, CROSS_MAP_ELEM_SIZE,
+                  crossMapLength, f) != crossMapLength)
     return -1;
   if ((*(s->saveGlobals)) (f) != 0)
     return -1;
+  /* f must be open for update, so that it can be read back. */
+  end = ftell (f);
+  if (end < 0 or fflush (f) != 0) return -1;
+  unless (checksumWorldFile (f, heapStart, heapEnd, end, &checksum))
+    return -1;
+  if (fseek (f, end, SEEK_SET) != 0) return -1;
+  if (fwrite (&checksum, sizeof(uint32_t), 1, f) != 1) return -1;
   return 0;
 }
 
+/* Whether fileName is the world file that the heap is mapped from. */
+static bool isMappedWorld (const char *fileName) {
+  struct stat st;
+
+  return worldIsMapped
+    and stat (fileName, &st) == 0
+    and st.st_dev == worldDev
+    and st.st_ino == worldIno;
+}
+
 void GC_saveWorld (GC_state s, NullString8_t fileName) {
   FILE *f;
   s->syncReason = SYNC_SAVE_WORLD;
   /* XXX is fileName heap allocated? */
   ENTER0 (s);
-  f = fopen ((const char*)fileName, "wb");
+  /* Truncating the world that is still mapped would take pages out
+   * from under the heap, so replace that file instead.
+   */
+  if (isMappedWorld ((const char*)fileName))
+    unlink ((const char*)fileName);
+  f = fopen ((const char*)fileName, "w+b");
   if (f == 0) {
     s->saveWorldStatus = false;
     goto done;
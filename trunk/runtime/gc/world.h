@@ -6,11 +6,63 @@
  * See the file MLton-LICENSE for details.
  */
 
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* In a world file, the heap starts at a multiple of this, so that it
+ * can be mapped in place on any page size up to it.
+ */
+#define GC_WORLD_HEAP_ALIGN 0x10000
+
+/* How the heap is stored in a world file.  The rest of the file, the
+ * header before the heap and the cross map and globals after it, is
+ * covered by a 32-bit Adler-32 checksum at the end of the file.
+ */
+typedef enum {
+  /* Raw, at a multiple of GC_WORLD_HEAP_ALIGN, to be mapped in. */
+  GC_WORLD_HEAP_MAPPED,
+  /* In chunks of at most the chunk size, each a 32-bit stored size, a
+   * 32-bit Adler-32 checksum of the raw chunk, and the chunk, either
+   * compressed with lzCompress or, if its stored size is its raw
+   * size, as it is.
+   */
+  GC_WORLD_HEAP_COMPRESSED,
+} GC_worldHeapFormat;
+
+#define GC_WORLD_CHUNK_SIZE 0x100000
+/* Chunks are compressed or decompressed by up to this many threads,
+ * a batch of up to two chunks per thread or GC_WORLD_BATCH_SIZE bytes
+ * at a time.
+ */
+#define GC_WORLD_MAX_WORKERS 64
+#define GC_WORLD_BATCH_SIZE 0x4000000
+
+struct GC_worldChunk {
+  pointer raw; /* in the heap */
+  size_t rawSize;
+  uint8_t *stored;
+  size_t storedSize; /* rawSize if the chunk isn't compressed */
+  uint32_t checksum;
+  bool ok;
+};
+
+/* Chunks to be worked on in parallel. */
+struct GC_worldChunkBatch {
+  struct GC_worldChunk *chunks;
+  size_t numChunks;
+  volatile size_t next; /* next chunk to be claimed by a worker */
+  void (*work) (struct GC_worldChunk *chunk);
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
 #if (defined (MLTON_GC_INTERNAL_FUNCS))
 
 static void loadWorldFromFILE (GC_state s, FILE *f);
 static void loadWorldFromFileName (GC_state s, const char *fileName);
+static bool checksumWorldFile (FILE *f, long heapStart, long heapEnd,
+                               long end, uint32_t *checksum);
 static int saveWorldToFILE (GC_state s, FILE *f);
+static bool isMappedWorld (const char *fileName);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
 
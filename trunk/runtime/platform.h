@@ -66,6 +66,15 @@
 #define SPAWN_MODE 0
 #endif
 
+/* The most buffers passed to one readv, writev or sendmsg. */
+#ifndef MLTON_IOV_MAX
+#if (defined (IOV_MAX) && IOV_MAX < 64)
+#define MLTON_IOV_MAX IOV_MAX
+#else
+#define MLTON_IOV_MAX 64
+#endif
+#endif
+
 
 /* Because HAS_FPCLASSIFY is unset, the runtime will provide it's own
  * implementation. It doesn't matter much what the values are, because
@@ -168,6 +177,11 @@ PRIVATE void *GC_mmapAnon_safe_protect (void *start, size_t length,
                                          size_t dead_low, size_t dead_high);
 PRIVATE void *GC_mremap (void *start, size_t oldLength, size_t newLength);
 PRIVATE void GC_release (void *base, size_t length);
+/* GC_mapFile maps length bytes of the file fd, from offset,
+ * copy-on-write over [start, start + length), replacing whatever was
+ * mapped there.  It returns (void*)-1 if it can't.
+ */
+PRIVATE void *GC_mapFile (void *start, size_t length, int fd, uintmax_t offset);
 
 PRIVATE size_t GC_pageSize (void);
 PRIVATE uintmax_t GC_physMem (void);
@@ -178,11 +192,84 @@ PRIVATE void GC_diskBack_close (void *data);
 PRIVATE void GC_diskBack_read (void *data, pointer buf, size_t size);
 PRIVATE void *GC_diskBack_write (pointer buf, size_t size);
 
+/* ------------------------------------------------- */
+/*                Futexes                            */
+/* ------------------------------------------------- */
+
+/* GC_futexWait blocks while *addr == val, for at most timeout
+ * microseconds or until a GC_futexWake on addr.  It may return
+ * spuriously, so callers must recheck.
+ */
+PRIVATE void GC_futexWait (volatile int32_t *addr, int32_t val, uint32_t timeout);
+PRIVATE void GC_futexWake (volatile int32_t *addr, int32_t count);
+
+/* ------------------------------------------------- */
+/*                Reactors                           */
+/* ------------------------------------------------- */
+
+/* A reactor waits for readiness on many file descriptors at once.
+ * GC_reactorCreate makes one, returning FALSE (with errno set) if the
+ * platform has none.  GC_reactorArm asks for one report, carrying
+ * token, when fd is ready for any of events; a reported fd must be
+ * armed again before it is reported again, and arming an armed fd
+ * replaces its events and token.  GC_reactorWait waits at most timeout
+ * milliseconds (forever if negative) and fills in tokens and events,
+ * returning how many it filled in (at most max) or -1 on error.
+ * GC_reactorWake makes the GC_reactorWait in progress, or the next
+ * one, return at once.
+ */
+#define GC_REACTOR_READ 0x1
+#define GC_REACTOR_WRITE 0x2
+#define GC_REACTOR_HANGUP 0x4
+
+struct GC_reactor {
+  int fd;
+  int wakeFd;
+};
+
+PRIVATE bool GC_reactorCreate (struct GC_reactor *r);
+PRIVATE int GC_reactorArm (struct GC_reactor *r, int fd,
+                           uint32_t events, uint32_t token);
+PRIVATE int GC_reactorDisarm (struct GC_reactor *r, int fd);
+PRIVATE int GC_reactorWait (struct GC_reactor *r, int timeout,
+                            uint32_t *tokens, uint32_t *events, int max);
+PRIVATE void GC_reactorWake (struct GC_reactor *r);
+
+/* ------------------------------------------------- */
+/*                NUMA                               */
+/* ------------------------------------------------- */
+
+#define GC_NUMA_MAX_NODES 64
+
+/* GC_numaNodeOfCPU returns the node of a cpu, or -1 if unknown.
+ * GC_numaPrefer moves the pages in a range to a node and prefers it
+ * for future faults.  GC_numaFirstTouch drops the pages in a range,
+ * which must hold no live data, so that each is placed on the node of
+ * whoever touches it next.  GC_numaNodeBytes counts the resident bytes
+ * of a range on each node.  Only whole pages inside a range are
+ * affected or counted.
+ */
+PRIVATE int GC_numaNumberOfNodes (void);
+PRIVATE int GC_numaNodeOfCPU (int cpu);
+PRIVATE void GC_numaPrefer (void *start, size_t length, int node);
+PRIVATE void GC_numaFirstTouch (void *start, size_t length);
+PRIVATE void GC_numaNodeBytes (void *start, size_t length,
+                               uintmax_t *bytes, int numNodes);
+
 /* ------------------------------------------------- */
 /*                SigProf Handler                    */
 /* ------------------------------------------------- */
 
 PRIVATE void GC_setSigProfHandler (struct sigaction *sa);
+/* Time profiling uses a CPU-time timer per processor thread where the
+ * platform has them.  GC_createThreadProfTimer makes one for the
+ * calling thread, returning FALSE if it can't; GC_setThreadProfTimer
+ * arms it to send SIGPROF every usec microseconds of the thread's CPU
+ * time (or disarms it, if usec is 0), returning FALSE if the calling
+ * thread has no timer.
+ */
+PRIVATE bool GC_createThreadProfTimer (void);
+PRIVATE bool GC_setThreadProfTimer (long usec);
 
 /* ---------------------------------------------------------------- */
 /*                         MLton libraries                          */
@@ -10,7 +10,12 @@
 #include <sys/vminfo.h>
 
 #include "diskBack.unix.c"
+#include "futex.pthread.c"
+#include "numa.none.c"
+#include "profTimer.none.c"
+#include "reactor.none.c"
 #include "mkdir2.c"
+#include "mapFile.unix.c"
 #include "mmap-protect.c"
 #include "nonwin.c"
 #include "recv.nonblock.c"
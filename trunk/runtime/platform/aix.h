@@ -17,6 +17,7 @@
 #include <sys/syslog.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include <sys/uio.h>
 #include <sys/types.h>
 #include <sys/un.h>
 #include <sys/utsname.h>
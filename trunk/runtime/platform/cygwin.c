@@ -2,6 +2,11 @@
 
 #include "platform.h"
 
+#include "futex.pthread.c"
+#include "numa.none.c"
+#include "profTimer.none.c"
+#include "reactor.none.c"
+#include "mapFile.none.c"
 #include "mkdir2.c"
 #include "mmap.c"
 #include "recv.nonblock.c"
@@ -22,6 +22,7 @@
 #include <sys/time.h>
 #include <sys/resource.h> /* <sys/resource.h> might not #include <sys/time.h> */
 #include <sys/times.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <sys/utsname.h>
 #include <sys/wait.h>
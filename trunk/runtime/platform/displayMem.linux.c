@@ -3,4 +3,8 @@ void GC_displayMem (void) {
 
         snprintf (buffer, cardof(buffer), "/bin/cat /proc/%d/maps\n", (int)(getpid ()));
         system (buffer);
+        /* Per-node page counts for each mapping, if the kernel has NUMA. */
+        snprintf (buffer, cardof(buffer), "/bin/cat /proc/%d/numa_maps 2>/dev/null\n",
+                  (int)(getpid ()));
+        system (buffer);
 }
@@ -0,0 +1,28 @@
+#include <sys/syscall.h>
+
+/* As with MREMAP_MAYMOVE in linux.c, avoid including the kernel
+ * headers just for these.
+ */
+#ifndef FUTEX_WAIT
+#define FUTEX_WAIT 0
+#endif
+#ifndef FUTEX_WAKE
+#define FUTEX_WAKE 1
+#endif
+#ifndef FUTEX_PRIVATE_FLAG
+#define FUTEX_PRIVATE_FLAG 128
+#endif
+
+void GC_futexWait (volatile int32_t *addr, int32_t val, uint32_t timeout) {
+        struct timespec ts;
+
+        ts.tv_sec = timeout / 1000000;
+        ts.tv_nsec = (timeout % 1000000) * 1000;
+        syscall (SYS_futex, addr, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, val,
+                 &ts, NULL, 0);
+}
+
+void GC_futexWake (volatile int32_t *addr, int32_t count) {
+        syscall (SYS_futex, addr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, count,
+                 NULL, NULL, 0);
+}
@@ -0,0 +1,33 @@
+/* Without futexes, waiters sleep on one condition variable.  The value
+ * is checked under the mutex that the waker takes to broadcast, so a
+ * wake that follows a change of *addr cannot be lost.  Every address
+ * shares the condition variable, so callers must recheck their
+ * condition after GC_futexWait returns.
+ */
+
+static pthread_mutex_t futexMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t futexCond = PTHREAD_COND_INITIALIZER;
+
+void GC_futexWait (volatile int32_t *addr, int32_t val, uint32_t timeout) {
+        struct timeval now;
+        struct timespec ts;
+
+        gettimeofday (&now, NULL);
+        ts.tv_sec = now.tv_sec + timeout / 1000000;
+        ts.tv_nsec = (now.tv_usec + timeout % 1000000) * 1000;
+        if (ts.tv_nsec >= 1000000000) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000;
+        }
+        pthread_mutex_lock (&futexMutex);
+        if (*addr == val)
+                pthread_cond_timedwait (&futexCond, &futexMutex, &ts);
+        pthread_mutex_unlock (&futexMutex);
+}
+
+void GC_futexWake (__attribute__ ((unused)) volatile int32_t *addr,
+                   __attribute__ ((unused)) int32_t count) {
+        pthread_mutex_lock (&futexMutex);
+        pthread_cond_broadcast (&futexCond);
+        pthread_mutex_unlock (&futexMutex);
+}
@@ -8,7 +8,12 @@
 #define MAP_ANON MAP_ANONYMOUS
 
 #include "diskBack.unix.c"
+#include "futex.pthread.c"
+#include "numa.none.c"
+#include "profTimer.none.c"
+#include "reactor.none.c"
 #include "mkdir2.c"
+#include "mapFile.unix.c"
 #include "mmap-protect.c"
 #include "nonwin.c"
 #include "recv.nonblock.c"
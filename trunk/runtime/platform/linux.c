@@ -5,8 +5,13 @@
 #include "diskBack.unix.c"
 #include "mkdir2.c"
 #include "displayMem.linux.c"
+#include "futex.linux.c"
+#include "mapFile.unix.c"
 #include "mmap-protect.c"
 #include "nonwin.c"
+#include "numa.linux.c"
+#include "profTimer.linux.c"
+#include "reactor.linux.c"
 #include "sysconf.c"
 #include "use-mmap.c"
 
@@ -0,0 +1,8 @@
+/* Without mmap, worlds are always read in. */
+
+void *GC_mapFile (__attribute__ ((unused)) void *start,
+                  __attribute__ ((unused)) size_t length,
+                  __attribute__ ((unused)) int fd,
+                  __attribute__ ((unused)) uintmax_t offset) {
+        return (void*)-1;
+}
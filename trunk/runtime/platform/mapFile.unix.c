@@ -0,0 +1,4 @@
+void *GC_mapFile (void *start, size_t length, int fd, uintmax_t offset) {
+        return mmap (start, length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED, fd, (off_t)offset);
+}
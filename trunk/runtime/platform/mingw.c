@@ -2,6 +2,11 @@
 
 #include "platform.h"
 
+#include "futex.pthread.c"
+#include "mapFile.none.c"
+#include "numa.none.c"
+#include "profTimer.none.c"
+#include "reactor.none.c"
 #include "windows.c"
 #include "mremap.c"
 
@@ -588,6 +593,37 @@ int pipe (int filedes[2]) {
         return 0;
 }
 
+/* One buffer at a time, stopping at the first short transfer. */
+ssize_t readv (int fd, const struct iovec *iov, int iovcnt) {
+        ssize_t total, res;
+
+        total = 0;
+        for (int i = 0; i < iovcnt; i++) {
+                res = read (fd, iov[i].iov_base, iov[i].iov_len);
+                if (res < 0)
+                        return (0 == total) ? res : total;
+                total += res;
+                if ((size_t)res < iov[i].iov_len)
+                        break;
+        }
+        return total;
+}
+
+ssize_t writev (int fd, const struct iovec *iov, int iovcnt) {
+        ssize_t total, res;
+
+        total = 0;
+        for (int i = 0; i < iovcnt; i++) {
+                res = write (fd, iov[i].iov_base, iov[i].iov_len);
+                if (res < 0)
+                        return (0 == total) ? res : total;
+                total += res;
+                if ((size_t)res < iov[i].iov_len)
+                        break;
+        }
+        return total;
+}
+
 /* ------------------------------------------------- */
 /*                   Posix.ProcEnv                   */
 /* ------------------------------------------------- */
@@ -1114,6 +1150,13 @@ int socketpair (__attribute__ ((unused)) int d,
         die ("socketpair not implemented");
 }
 
+__attribute__ ((noreturn))
+ssize_t sendmsg (__attribute__ ((unused)) int s,
+                 __attribute__ ((unused)) const struct msghdr *msg,
+                 __attribute__ ((unused)) int flags) {
+        die ("sendmsg not implemented");
+}
+
 void MLton_initSockets (void) {
         static Bool isInitialized = FALSE;
         WORD version;
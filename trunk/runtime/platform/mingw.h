@@ -516,17 +516,30 @@ struct MLton_flock {
 #undef flock
 #define flock MLton_flock
 
+struct MLton_iovec {
+        void *iov_base;
+        size_t iov_len;
+};
+#undef iovec
+#define iovec MLton_iovec
+
 MLTON_WRAPPER int MLton_fcntl (int fd, int cmd, ...);
 MLTON_WRAPPER int MLton_fsync (int fd);
 MLTON_WRAPPER int MLton_pipe (int filedes[2]);
+MLTON_WRAPPER ssize_t MLton_readv (int fd, const struct iovec *iov, int iovcnt);
+MLTON_WRAPPER ssize_t MLton_writev (int fd, const struct iovec *iov, int iovcnt);
 
 #undef fcntl
 #undef fsync
 #undef pipe
+#undef readv
+#undef writev
 
 #define fcntl MLton_fcntl
 #define fsync MLton_fsync
 #define pipe MLton_pipe
+#define readv MLton_readv
+#define writev MLton_writev
 
 /* ------------------------------------------------- */
 /*                   Posix.ProcEnv                   */
@@ -1391,6 +1404,22 @@ MLTON_WRAPPER int MLton_tcsetpgrp (int fd, pid_t pgrpid);
 #define UNIX_PATH_MAX 108
 #endif
 
+struct MLton_msghdr {
+        void *msg_name;
+        int msg_namelen;
+        struct iovec *msg_iov;
+        int msg_iovlen;
+        void *msg_control;
+        int msg_controllen;
+        int msg_flags;
+};
+#undef msghdr
+#define msghdr MLton_msghdr
+
+MLTON_WRAPPER ssize_t MLton_sendmsg (int s, const struct msghdr *msg, int flags);
+#undef sendmsg
+#define sendmsg MLton_sendmsg
+
 typedef unsigned short MLton_sa_family_t;
 #undef sa_family_t
 #define sa_family_t MLton_sa_family_t
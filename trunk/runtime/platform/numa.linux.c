@@ -0,0 +1,119 @@
+#include <dirent.h>
+#include <sys/syscall.h>
+
+/* As with futex.linux.c, avoid depending on libnuma or the kernel
+ * headers just for these.
+ */
+#ifndef MPOL_DEFAULT
+#define MPOL_DEFAULT 0
+#endif
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1 << 1)
+#endif
+
+/* Nodes are found in sysfs as nodeN entries of the given directory. */
+static int numaMaxNodeIn (const char *dirName) {
+        DIR *dir;
+        struct dirent *entry;
+        int max;
+        int node;
+
+        max = -1;
+        dir = opendir (dirName);
+        if (NULL == dir)
+                return -1;
+        while (NULL != (entry = readdir (dir)))
+                if (1 == sscanf (entry->d_name, "node%d", &node) and node > max)
+                        max = node;
+        closedir (dir);
+        return max;
+}
+
+int GC_numaNumberOfNodes (void) {
+        int max;
+
+        max = numaMaxNodeIn ("/sys/devices/system/node");
+        if (max < 0)
+                return 1;
+        return min (max + 1, GC_NUMA_MAX_NODES);
+}
+
+int GC_numaNodeOfCPU (int cpu) {
+        char buffer[64];
+        int node;
+
+        snprintf (buffer, cardof(buffer), "/sys/devices/system/cpu/cpu%d", cpu);
+        node = numaMaxNodeIn (buffer);
+        if (node >= GC_NUMA_MAX_NODES)
+                return -1;
+        return node;
+}
+
+static bool numaPageRange (void **start, size_t *length) {
+        size_t pageSize;
+        uintptr_t front, back;
+
+        pageSize = GC_pageSize ();
+        front = alignMax ((uintptr_t)*start, pageSize);
+        back = alignMaxDown ((uintptr_t)*start + *length, pageSize);
+        if (back <= front)
+                return FALSE;
+        *start = (void*)front;
+        *length = back - front;
+        return TRUE;
+}
+
+static void numaBind (void *start, size_t length, int mode,
+                      unsigned long nodeMask, unsigned int flags) {
+        syscall (SYS_mbind, start, length, mode,
+                 (MPOL_DEFAULT == mode) ? NULL : &nodeMask,
+                 (MPOL_DEFAULT == mode) ? 0 : 8 * sizeof (nodeMask) + 1,
+                 flags);
+}
+
+void GC_numaPrefer (void *start, size_t length, int node) {
+        unless (0 <= node and node < GC_NUMA_MAX_NODES
+                and numaPageRange (&start, &length))
+                return;
+        numaBind (start, length, MPOL_PREFERRED, 1UL << node, MPOL_MF_MOVE);
+}
+
+void GC_numaFirstTouch (void *start, size_t length) {
+        unless (numaPageRange (&start, &length))
+                return;
+        numaBind (start, length, MPOL_DEFAULT, 0, 0);
+        madvise (start, length, MADV_DONTNEED);
+}
+
+void GC_numaNodeBytes (void *start, size_t length,
+                       uintmax_t *bytes, int numNodes) {
+        enum { BATCH = 1024 };
+        void *pages[BATCH];
+        int status[BATCH];
+        size_t pageSize;
+        size_t numPages;
+
+        for (int i = 0; i < numNodes; i++)
+                bytes[i] = 0;
+        unless (numaPageRange (&start, &length))
+                return;
+        pageSize = GC_pageSize ();
+        numPages = length / pageSize;
+        for (size_t i = 0; i < numPages; i += BATCH) {
+                size_t count = min (numPages - i, (size_t)BATCH);
+
+                for (size_t j = 0; j < count; j++)
+                        pages[j] = (char*)start + (i + j) * pageSize;
+                /* With no target nodes, move_pages only reports where
+                 * each page is; pages never touched come back negative.
+                 */
+                if (0 != syscall (SYS_move_pages, 0, count, pages, NULL, status, 0))
+                        return;
+                for (size_t j = 0; j < count; j++)
+                        if (0 <= status[j] and status[j] < numNodes)
+                                bytes[status[j]] += pageSize;
+        }
+}
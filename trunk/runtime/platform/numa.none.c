@@ -0,0 +1,29 @@
+/* Without NUMA support, everything is on node 0 and placement requests
+ * are ignored.
+ */
+
+int GC_numaNumberOfNodes (void) {
+        return 1;
+}
+
+int GC_numaNodeOfCPU (__attribute__ ((unused)) int cpu) {
+        return -1;
+}
+
+void GC_numaPrefer (__attribute__ ((unused)) void *start,
+                    __attribute__ ((unused)) size_t length,
+                    __attribute__ ((unused)) int node) {
+}
+
+void GC_numaFirstTouch (__attribute__ ((unused)) void *start,
+                        __attribute__ ((unused)) size_t length) {
+}
+
+void GC_numaNodeBytes (__attribute__ ((unused)) void *start,
+                       size_t length,
+                       uintmax_t *bytes, int numNodes) {
+        for (int i = 0; i < numNodes; i++)
+                bytes[i] = 0;
+        if (numNodes > 0)
+                bytes[0] = length;
+}
@@ -1,8 +1,13 @@
 #include "platform.h"
 
 #include "diskBack.unix.c"
+#include "futex.pthread.c"
+#include "numa.none.c"
+#include "profTimer.none.c"
+#include "reactor.none.c"
 #include "mkdir2.c"
 #include "displayMem.linux.c"
+#include "mapFile.unix.c"
 #include "mmap-protect.c"
 #include "nonwin.c"
 #include "sysctl.c"
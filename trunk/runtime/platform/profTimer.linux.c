@@ -0,0 +1,40 @@
+#include <sys/syscall.h>
+
+/* Older glibcs don't name the thread id field of struct sigevent. */
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+static __thread bool threadProfTimerIsCreated = FALSE;
+static __thread timer_t threadProfTimer;
+
+/* Creates a timer, disarmed, that sends SIGPROF to the calling thread
+ * as it uses CPU time.
+ */
+bool GC_createThreadProfTimer (void) {
+        struct sigevent sev;
+
+        if (threadProfTimerIsCreated)
+                return TRUE;
+        memset (&sev, 0, sizeof (sev));
+        sev.sigev_notify = SIGEV_THREAD_ID;
+        sev.sigev_signo = SIGPROF;
+        sev.sigev_notify_thread_id = (pid_t)syscall (SYS_gettid);
+        if (0 != timer_create (CLOCK_THREAD_CPUTIME_ID, &sev, &threadProfTimer))
+                return FALSE;
+        threadProfTimerIsCreated = TRUE;
+        return TRUE;
+}
+
+bool GC_setThreadProfTimer (long usec) {
+        struct itimerspec its;
+
+        unless (threadProfTimerIsCreated)
+                return FALSE;
+        its.it_interval.tv_sec = usec / 1000000;
+        its.it_interval.tv_nsec = (usec % 1000000) * 1000;
+        its.it_value = its.it_interval;
+        unless (0 == timer_settime (threadProfTimer, 0, &its, NULL))
+                diee ("GC_setThreadProfTimer: timer_settime failed");
+        return TRUE;
+}
@@ -0,0 +1,11 @@
+/* Without per-thread CPU-time timers, time profiling falls back to a
+ * single process-wide ITIMER_PROF.
+ */
+
+bool GC_createThreadProfTimer (void) {
+        return FALSE;
+}
+
+bool GC_setThreadProfTimer (__attribute__ ((unused)) long usec) {
+        return FALSE;
+}
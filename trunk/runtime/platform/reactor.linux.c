@@ -0,0 +1,102 @@
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+/* Each reactor is an epoll instance with an eventfd in it, so that it
+ * can be woken.  Every other fd is registered one shot, with its token
+ * as the event data; the eventfd's data is out of the range of tokens.
+ */
+#define REACTOR_WAKE_DATA ((uint64_t)1 << 32)
+/* Most events taken from the kernel in one GC_reactorWait. */
+#define REACTOR_MAX_EVENTS 256
+
+bool GC_reactorCreate (struct GC_reactor *r) {
+        struct epoll_event ev;
+
+        r->fd = epoll_create1 (EPOLL_CLOEXEC);
+        if (-1 == r->fd)
+                return FALSE;
+        r->wakeFd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (-1 == r->wakeFd) {
+                close (r->fd);
+                r->fd = -1;
+                return FALSE;
+        }
+        memset (&ev, 0, sizeof (ev));
+        ev.events = EPOLLIN;
+        ev.data.u64 = REACTOR_WAKE_DATA;
+        if (-1 == epoll_ctl (r->fd, EPOLL_CTL_ADD, r->wakeFd, &ev))
+                diee ("epoll_ctl of reactor wake up failed");
+        return TRUE;
+}
+
+int GC_reactorArm (struct GC_reactor *r, int fd,
+                   uint32_t events, uint32_t token) {
+        struct epoll_event ev;
+
+        memset (&ev, 0, sizeof (ev));
+        ev.events = EPOLLONESHOT | EPOLLRDHUP;
+        if (events & GC_REACTOR_READ)
+                ev.events |= EPOLLIN | EPOLLPRI;
+        if (events & GC_REACTOR_WRITE)
+                ev.events |= EPOLLOUT;
+        ev.data.u64 = token;
+        /* Most fds are armed many times, so try modifying first. */
+        if (0 == epoll_ctl (r->fd, EPOLL_CTL_MOD, fd, &ev))
+                return 0;
+        if (ENOENT != errno)
+                return -1;
+        return epoll_ctl (r->fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+int GC_reactorDisarm (struct GC_reactor *r, int fd) {
+        struct epoll_event ev;
+
+        /* Kernels before 2.6.9 want an event even though it is ignored. */
+        memset (&ev, 0, sizeof (ev));
+        if (0 == epoll_ctl (r->fd, EPOLL_CTL_DEL, fd, &ev) or ENOENT == errno)
+                return 0;
+        return -1;
+}
+
+int GC_reactorWait (struct GC_reactor *r, int timeout,
+                    uint32_t *tokens, uint32_t *events, int max) {
+        struct epoll_event evs[REACTOR_MAX_EVENTS];
+        int i, n, res;
+
+        if (max > REACTOR_MAX_EVENTS)
+                max = REACTOR_MAX_EVENTS;
+        n = epoll_wait (r->fd, evs, max, timeout);
+        if (-1 == n)
+                return (EINTR == errno) ? 0 : -1;
+        res = 0;
+        for (i = 0; i < n; i++) {
+                uint32_t e;
+
+                if (REACTOR_WAKE_DATA == evs[i].data.u64) {
+                        uint64_t count;
+
+                        /* Drain it, so that it is not reported again. */
+                        while (read (r->wakeFd, &count, sizeof (count)) > 0)
+                                ;
+                        continue;
+                }
+                e = 0;
+                if (evs[i].events & (EPOLLIN | EPOLLPRI))
+                        e |= GC_REACTOR_READ;
+                if (evs[i].events & EPOLLOUT)
+                        e |= GC_REACTOR_WRITE;
+                if (evs[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP))
+                        e |= GC_REACTOR_HANGUP;
+                tokens[res] = (uint32_t)evs[i].data.u64;
+                events[res] = e;
+                res++;
+        }
+        return res;
+}
+
+void GC_reactorWake (struct GC_reactor *r) {
+        uint64_t one = 1;
+
+        /* If the counter is full, a wake up is already pending. */
+        (void)write (r->wakeFd, &one, sizeof (one));
+}
@@ -0,0 +1,36 @@
+/* Without a reactor, PacML falls back on blocking calls in its I/O
+ * processors.
+ */
+
+bool GC_reactorCreate (struct GC_reactor *r) {
+        r->fd = -1;
+        r->wakeFd = -1;
+        errno = ENOSYS;
+        return FALSE;
+}
+
+int GC_reactorArm (__attribute__ ((unused)) struct GC_reactor *r,
+                   __attribute__ ((unused)) int fd,
+                   __attribute__ ((unused)) uint32_t events,
+                   __attribute__ ((unused)) uint32_t token) {
+        errno = ENOSYS;
+        return -1;
+}
+
+int GC_reactorDisarm (__attribute__ ((unused)) struct GC_reactor *r,
+                      __attribute__ ((unused)) int fd) {
+        errno = ENOSYS;
+        return -1;
+}
+
+int GC_reactorWait (__attribute__ ((unused)) struct GC_reactor *r,
+                    __attribute__ ((unused)) int timeout,
+                    __attribute__ ((unused)) uint32_t *tokens,
+                    __attribute__ ((unused)) uint32_t *events,
+                    __attribute__ ((unused)) int max) {
+        errno = ENOSYS;
+        return -1;
+}
+
+void GC_reactorWake (__attribute__ ((unused)) struct GC_reactor *r) {
+}
@@ -4,7 +4,12 @@
 
 #include "diskBack.unix.c"
 #include "float-math.c"
+#include "futex.pthread.c"
+#include "numa.none.c"
+#include "profTimer.none.c"
+#include "reactor.none.c"
 #include "mkdir2.c"
+#include "mapFile.unix.c"
 #include "mmap.c"
 #include "mmap-protect.c"
 #include "nonwin.c"
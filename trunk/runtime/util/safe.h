@@ -85,6 +85,15 @@ static inline void *malloc_safe (size_t size) {
   return res;
 }
 
+static inline void *realloc_safe (void *ptr, size_t size) {
+  void *res;
+
+  res = realloc (ptr, size);
+  if (NULL == res)
+    die ("realloc (_, %"PRIuMAX") failed.\n", (uintmax_t)size);
+  return res;
+}
+
 static inline int mkstemp_safe (char *template) {
   int fd;
 